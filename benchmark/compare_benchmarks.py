@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+#
+# Compares two Google Benchmark JSON result files (--benchmark_out_format=json) and flags
+# regressions: benchmarks whose time grew by more than the threshold relative to the baseline.
+#
+#    compare_benchmarks.py baseline.json current.json [--threshold 0.05] [--metric real_time]
+#
+# Prints one line per benchmark found in both files and exits with status 1 if anything
+# regressed, so it can gate a CI job. Benchmarks present in only one file are listed but never
+# count as regressions. With --benchmark_repetitions, the median aggregate is compared when the
+# file has one, since it is less sensitive to outliers than the mean.
+
+import argparse
+import json
+import sys
+
+# Google Benchmark reports times in the unit each benchmark asked for
+TIME_UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+
+def load(path, metric):
+    with open(path, encoding="utf-8") as file:
+        report = json.load(file)
+
+    plain = {}
+    medians = {}
+    for run in report.get("benchmarks", []):
+        if run.get("error_occurred"):
+            continue
+        seconds = run[metric] * TIME_UNITS[run.get("time_unit", "ns")]
+        if run.get("run_type") == "aggregate":
+            if run.get("aggregate_name") == "median":
+                medians[run["run_name"]] = seconds
+        else:
+            name = run.get("run_name", run["name"])
+            plain.setdefault(name, []).append(seconds)
+
+    # without a median, repeated plain runs of one benchmark are reduced to their minimum
+    times = {name: min(runs) for name, runs in plain.items()}
+    times.update(medians)
+    return report.get("context", {}), times
+
+
+def format_time(seconds):
+    for unit, scale in (("s", 1.0), ("ms", 1e-3), ("us", 1e-6)):
+        if seconds >= scale:
+            return f"{seconds / scale:.3f} {unit}"
+    return f"{seconds / 1e-9:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Flags regressions between two Google Benchmark JSON result files")
+    parser.add_argument("baseline", help="JSON results to compare against")
+    parser.add_argument("current", help="JSON results to check")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown that counts as a regression (default 0.05)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"), default="real_time",
+                        help="which time to compare (default real_time)")
+    args = parser.parse_args()
+
+    baseline_context, baseline = load(args.baseline, args.metric)
+    current_context, current = load(args.current, args.metric)
+
+    for key in ("host_name", "num_cpus", "library_build_type"):
+        if baseline_context.get(key) != current_context.get(key):
+            print(f"warning: {key} differs ({baseline_context.get(key)} vs "
+                  f"{current_context.get(key)}); the comparison may not be meaningful")
+
+    regressions = []
+    width = max((len(name) for name in baseline.keys() | current.keys()), default=0)
+    for name in sorted(baseline.keys() & current.keys()):
+        change = current[name] / baseline[name] - 1.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            flag = "  improved"
+        print(f"{name:<{width}}  {format_time(baseline[name]):>12}  "
+              f"{format_time(current[name]):>12}  {change:+8.1%}{flag}")
+
+    for name in sorted(baseline.keys() - current.keys()):
+        print(f"{name:<{width}}  only in baseline")
+    for name in sorted(current.keys() - baseline.keys()):
+        print(f"{name:<{width}}  only in current")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) above {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
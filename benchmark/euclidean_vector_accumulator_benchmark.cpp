@@ -0,0 +1,34 @@
+// Scaling of concurrent gradient accumulation: one mutex-guarded total versus
+// euclidean_vector_accumulator's per-thread shards. Per-thread throughput (items_per_second)
+// should stay flat as threads are added for the accumulator, and fall for the mutex.
+
+#include "comp6771/euclidean_vector_accumulator.hpp"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+namespace {
+	constexpr auto dimensions = 1024;
+
+	void bm_mutex_total(benchmark::State& state) {
+		static auto total = comp6771::euclidean_vector(dimensions);
+		static auto mutex = std::mutex();
+		auto const gradient = comp6771::euclidean_vector(dimensions, 1e-3);
+		for (auto _ : state) {
+			auto const lock = std::lock_guard(mutex);
+			total += gradient;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK(bm_mutex_total)->ThreadRange(1, 16)->UseRealTime();
+
+	void bm_sharded_accumulator(benchmark::State& state) {
+		static auto accumulator = comp6771::euclidean_vector_accumulator(dimensions);
+		auto const gradient = comp6771::euclidean_vector(dimensions, 1e-3);
+		for (auto _ : state) {
+			accumulator.add(gradient);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK(bm_sharded_accumulator)->ThreadRange(1, 16)->UseRealTime();
+} // namespace
@@ -0,0 +1,128 @@
+// Checked versus unchecked (comp6771::unchecked) element-wise updates and dot products. For small
+// vectors the fixed cost of each call (dimension check, error path, copying for dot()) is most of
+// the time, which is where the unchecked overloads pay off.
+//
+// Also the effect of allocation_policy on large vectors: construction (first touch), and dot and
+// axpy throughput, which is bound by memory and TLB behaviour at this size. The argument selects
+// the policy: 0 default, 1 huge pages, 2 first touch from every thread, 3 both. Compare
+// bytes_per_second between them; huge pages only help if the kernel has transparent huge pages
+// enabled (/sys/kernel/mm/transparent_hugepage/enabled set to always or madvise).
+
+#include "comp6771/euclidean_vector.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+namespace {
+	auto make_vector(int const dimensions, double const start) -> comp6771::euclidean_vector {
+		auto ev = comp6771::euclidean_vector(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			ev[i] = start + i;
+		}
+		return ev;
+	}
+
+	void bm_checked_add(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto y = make_vector(dimensions, 0.0);
+		auto const x = make_vector(dimensions, 1e-9);
+		for (auto _ : state) {
+			y += x;
+			benchmark::DoNotOptimize(y);
+		}
+	}
+	BENCHMARK(bm_checked_add)->RangeMultiplier(2)->Range(2, 256);
+
+	void bm_unchecked_add(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto y = make_vector(dimensions, 0.0);
+		auto const x = make_vector(dimensions, 1e-9);
+		for (auto _ : state) {
+			y.add(x, comp6771::unchecked);
+			benchmark::DoNotOptimize(y);
+		}
+	}
+	BENCHMARK(bm_unchecked_add)->RangeMultiplier(2)->Range(2, 256);
+
+	void bm_checked_axpy(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto y = make_vector(dimensions, 0.0);
+		auto const x = make_vector(dimensions, 1.0);
+		for (auto _ : state) {
+			y.axpy(1e-9, x);
+			benchmark::DoNotOptimize(y);
+		}
+	}
+	BENCHMARK(bm_checked_axpy)->RangeMultiplier(2)->Range(2, 256);
+
+	void bm_unchecked_axpy(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto y = make_vector(dimensions, 0.0);
+		auto const x = make_vector(dimensions, 1.0);
+		for (auto _ : state) {
+			y.axpy(1e-9, x, comp6771::unchecked);
+			benchmark::DoNotOptimize(y);
+		}
+	}
+	BENCHMARK(bm_unchecked_axpy)->RangeMultiplier(2)->Range(2, 256);
+
+	void bm_checked_dot(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const x = make_vector(dimensions, 0.0);
+		auto const y = make_vector(dimensions, 1.0);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(x, y));
+		}
+	}
+	BENCHMARK(bm_checked_dot)->RangeMultiplier(2)->Range(2, 256);
+
+	void bm_unchecked_dot(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const x = make_vector(dimensions, 0.0);
+		auto const y = make_vector(dimensions, 1.0);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(x, y, comp6771::unchecked));
+		}
+	}
+	BENCHMARK(bm_unchecked_dot)->RangeMultiplier(2)->Range(2, 256);
+
+	constexpr auto large_dimensions = 1 << 24; // 128 MiB per vector
+
+	auto policy(benchmark::State const& state) -> comp6771::allocation_policy {
+		auto const index = state.range(0);
+		return comp6771::allocation_policy{index == 1 or index == 3, index >= 2 ? 0 : 1};
+	}
+
+	void bm_policy_construct(benchmark::State& state) {
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(large_dimensions, 1.0, policy(state));
+			benchmark::DoNotOptimize(ev.data());
+		}
+		state.SetBytesProcessed(state.iterations() * large_dimensions
+		                        * static_cast<std::int64_t>(sizeof(double)));
+	}
+	BENCHMARK(bm_policy_construct)->DenseRange(0, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	void bm_policy_dot(benchmark::State& state) {
+		auto const x = comp6771::euclidean_vector(large_dimensions, 1.0, policy(state));
+		auto const y = comp6771::euclidean_vector(large_dimensions, 2.0, policy(state));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(x, y, comp6771::unchecked));
+		}
+		state.SetBytesProcessed(state.iterations() * 2 * large_dimensions
+		                        * static_cast<std::int64_t>(sizeof(double)));
+	}
+	BENCHMARK(bm_policy_dot)->DenseRange(0, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	void bm_policy_axpy(benchmark::State& state) {
+		auto y = comp6771::euclidean_vector(large_dimensions, 1.0, policy(state));
+		auto const x = comp6771::euclidean_vector(large_dimensions, 2.0, policy(state));
+		for (auto _ : state) {
+			y.axpy(1e-9, x, comp6771::unchecked);
+			benchmark::DoNotOptimize(y.data());
+		}
+		state.SetBytesProcessed(state.iterations() * 3 * large_dimensions
+		                        * static_cast<std::int64_t>(sizeof(double)));
+	}
+	BENCHMARK(bm_policy_axpy)->DenseRange(0, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+} // namespace
@@ -0,0 +1,178 @@
+// End-to-end workloads, shaped like the way euclidean_vector is actually used, rather than one
+// operation at a time: k-NN scoring of a query against a corpus, an SGD-with-momentum training
+// loop, text ingest and export, and normalising a large corpus. Each one goes through the public
+// API only, so a change anywhere in source/euclidean_vector.cpp (or the libraries built on it)
+// shows up here the way users would see it.
+//
+// These are the benchmarks to check for regressions. Record a baseline from an unchanged tree
+// and compare a later run against it (on the same machine, with the same build type):
+//
+//    euclidean_vector_workload_benchmark --benchmark_out=baseline.json --benchmark_out_format=json
+//    euclidean_vector_workload_benchmark --benchmark_out=current.json --benchmark_out_format=json
+//    python3 benchmark/compare_benchmarks.py baseline.json current.json
+//
+// The workload_benchmark_baseline and workload_benchmark_compare targets in
+// benchmark/CMakeLists.txt run exactly those steps.
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_pipeline.hpp"
+#include "random_inputs.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	// fixed seeds, so every run sees the same data
+	constexpr auto corpus_seed = std::uint32_t{6771};
+	constexpr auto query_seed = std::uint32_t{1776};
+
+	auto make_corpus(std::size_t const count, int const dimensions, std::uint32_t const seed = corpus_seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		return random_inputs::random_vectors(count, dimensions, seed);
+	}
+
+	// one vector per line, magnitudes separated by spaces: the format read_vectors() takes
+	auto make_text(std::vector<comp6771::euclidean_vector> const& corpus) -> std::string {
+		auto out = std::ostringstream();
+		out.precision(17);
+		for (auto const& ev : corpus) {
+			auto separator = "";
+			for (auto const magnitude : ev) {
+				out << separator << magnitude;
+				separator = " ";
+			}
+			out << '\n';
+		}
+		return out.str();
+	}
+
+	// k-NN scoring: dot() of a unit query against a unit-normalised corpus (so the score is cosine
+	// similarity), then the best k. The argument is the corpus size
+	void bm_knn_scoring(benchmark::State& state) {
+		constexpr auto dimensions = 128;
+		constexpr auto k = std::size_t{10};
+		auto corpus = make_corpus(static_cast<std::size_t>(state.range(0)), dimensions);
+		comp6771::normalise(corpus);
+		auto const query = comp6771::unit(make_corpus(1, dimensions, query_seed).front());
+
+		struct neighbour {
+			double score;
+			std::size_t index;
+		};
+		auto scores = std::vector<neighbour>(corpus.size());
+		for (auto _ : state) {
+			for (auto i = std::size_t{0}; i < corpus.size(); ++i) {
+				scores[i] = {comp6771::dot(corpus[i], query), i};
+			}
+			std::partial_sort(scores.begin(),
+			                  scores.begin() + static_cast<std::ptrdiff_t>(k),
+			                  scores.end(),
+			                  [](neighbour const& a, neighbour const& b) { return a.score > b.score; });
+			benchmark::DoNotOptimize(scores.front());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(bm_knn_scoring)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+	// iterative gradient updates: SGD with momentum over a fixed set of gradients. Each step is
+	// velocity = gradient + momentum * velocity, weights -= rate * velocity, plus a gradient norm
+	// for monitoring. The argument is the number of parameters
+	void bm_gradient_updates(benchmark::State& state) {
+		constexpr auto batches = std::size_t{16};
+		constexpr auto rate = 1e-3;
+		constexpr auto momentum = 0.9;
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const gradients = make_corpus(batches, dimensions);
+		auto weights = comp6771::euclidean_vector(dimensions);
+		auto velocity = comp6771::euclidean_vector(dimensions);
+
+		for (auto _ : state) {
+			auto gradient_norm = 0.0;
+			for (auto const& gradient : gradients) {
+				velocity.axpby(1.0, gradient, momentum);
+				weights.axpy(-rate, velocity);
+				gradient_norm += comp6771::euclidean_norm(gradient);
+			}
+			benchmark::DoNotOptimize(weights);
+			benchmark::DoNotOptimize(gradient_norm);
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batches));
+	}
+	BENCHMARK(bm_gradient_updates)->Arg(1'024)->Arg(65'536)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+	// text ingest: parsing a corpus with read_vectors(), and the full streaming pipeline from text
+	// to scores. The argument is the number of lines (64 magnitudes each)
+	void bm_text_ingest(benchmark::State& state) {
+		auto const text = make_text(make_corpus(static_cast<std::size_t>(state.range(0)), 64));
+		for (auto _ : state) {
+			auto in = std::istringstream(text);
+			auto dimensions = 0;
+			for (auto const& ev : comp6771::read_vectors(in)) {
+				dimensions += ev.dimensions();
+			}
+			benchmark::DoNotOptimize(dimensions);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+	}
+	BENCHMARK(bm_text_ingest)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+
+	void bm_text_pipeline(benchmark::State& state) {
+		constexpr auto dimensions = 64;
+		auto const text = make_text(make_corpus(static_cast<std::size_t>(state.range(0)), dimensions));
+		auto const query = comp6771::unit(make_corpus(1, dimensions, query_seed).front());
+		for (auto _ : state) {
+			auto in = std::istringstream(text);
+			auto out = std::ostringstream();
+			auto const written =
+			   comp6771::write_scores(comp6771::score(comp6771::normalise(comp6771::read_vectors(in)), query),
+			                          out);
+			benchmark::DoNotOptimize(written);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+	}
+	BENCHMARK(bm_text_pipeline)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+
+	// text export: operator<< over a corpus. The argument is the number of vectors (64 magnitudes
+	// each)
+	void bm_text_export(benchmark::State& state) {
+		auto const corpus = make_corpus(static_cast<std::size_t>(state.range(0)), 64);
+		auto bytes = std::int64_t{0};
+		for (auto _ : state) {
+			auto out = std::ostringstream();
+			for (auto const& ev : corpus) {
+				out << ev << '\n';
+			}
+			bytes += static_cast<std::int64_t>(out.tellp());
+		}
+		state.SetBytesProcessed(bytes);
+	}
+	BENCHMARK(bm_text_export)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+
+	// normalisation of a large corpus with the batched normalise(), from 1 to 8 threads. Each
+	// iteration restores the original corpus first (outside the timing), since normalising is in
+	// place. Arguments: corpus size, threads
+	void bm_normalise_corpus(benchmark::State& state) {
+		constexpr auto dimensions = 256;
+		auto const threads = static_cast<int>(state.range(1));
+		auto const original = make_corpus(static_cast<std::size_t>(state.range(0)), dimensions);
+		auto corpus = original;
+		for (auto _ : state) {
+			state.PauseTiming();
+			corpus = original; // also frees the previous iteration's storage, untimed
+			state.ResumeTiming();
+			auto const zero = comp6771::normalise(corpus, threads);
+			benchmark::DoNotOptimize(zero);
+			benchmark::DoNotOptimize(corpus.front());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(bm_normalise_corpus)
+	   ->ArgsProduct({{10'000, 100'000}, {1, 2, 4, 8}})
+	   ->Unit(benchmark::kMillisecond)
+	   ->UseRealTime();
+} // namespace
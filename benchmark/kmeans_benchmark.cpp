@@ -0,0 +1,116 @@
+// k-means on synthetic data: Gaussian blobs in 32 dimensions, 16 clusters. Lloyd and mini-batch
+// iterations at several data sizes and thread counts, plus the hand-written loop the library
+// replaces (operator-, euclidean_norm and operator+= on separate euclidean_vectors), which
+// allocates for every distance. items_per_second counts point-iterations, so the runs are
+// comparable whatever number of iterations each one took.
+
+#include "comp6771/kmeans.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+	constexpr auto dimensions = 32;
+	constexpr auto clusters = 16;
+	constexpr auto iterations = 10;
+
+	auto make_points(int const rows) -> comp6771::euclidean_matrix {
+		auto engine = std::mt19937_64(6771);
+		auto centre = std::uniform_real_distribution<double>(-10.0, 10.0);
+		auto jitter = std::normal_distribution<double>(0.0, 1.0);
+		auto centres = comp6771::euclidean_matrix(clusters, dimensions);
+		for (auto c = 0; c < clusters; ++c) {
+			for (auto d = 0; d < dimensions; ++d) {
+				centres(c, d) = centre(engine);
+			}
+		}
+		auto points = comp6771::euclidean_matrix(rows, dimensions);
+		for (auto i = 0; i < rows; ++i) {
+			for (auto d = 0; d < dimensions; ++d) {
+				points(i, d) = centres(i % clusters, d) + jitter(engine);
+			}
+		}
+		return points;
+	}
+
+	// Arguments: points, threads. tolerance 0, so every run does exactly `iterations` iterations
+	// (unless the assignments settle first)
+	void bm_lloyd(benchmark::State& state) {
+		auto const points = make_points(static_cast<int>(state.range(0)));
+		auto const options = comp6771::kmeans_options{.clusters = clusters,
+		                                              .max_iterations = iterations,
+		                                              .tolerance = 0.0,
+		                                              .threads = static_cast<int>(state.range(1))};
+		auto done = std::int64_t{0};
+		for (auto _ : state) {
+			auto const result = comp6771::kmeans(points, options);
+			benchmark::DoNotOptimize(result.inertia);
+			done += result.iterations;
+		}
+		state.SetItemsProcessed(done * state.range(0));
+	}
+	BENCHMARK(bm_lloyd)
+	   ->ArgsProduct({{10'000, 100'000, 1'000'000}, {1, 2, 4, 8}})
+	   ->Unit(benchmark::kMillisecond)
+	   ->UseRealTime();
+
+	// Arguments: points, threads; batches of 1024
+	void bm_mini_batch(benchmark::State& state) {
+		auto const points = make_points(static_cast<int>(state.range(0)));
+		auto const options = comp6771::kmeans_options{.clusters = clusters,
+		                                              .max_iterations = 100,
+		                                              .tolerance = 0.0,
+		                                              .batch_size = 1024,
+		                                              .threads = static_cast<int>(state.range(1))};
+		for (auto _ : state) {
+			auto const result = comp6771::kmeans(points, options);
+			benchmark::DoNotOptimize(result.inertia);
+		}
+	}
+	BENCHMARK(bm_mini_batch)
+	   ->ArgsProduct({{100'000, 1'000'000}, {1, 4}})
+	   ->Unit(benchmark::kMillisecond)
+	   ->UseRealTime();
+
+	// The hand-written Lloyd iteration: one temporary per distance, one per centroid update.
+	// Starts from the first `clusters` points rather than k-means++, which only flatters it
+	void bm_hand_written_lloyd(benchmark::State& state) {
+		auto const matrix = make_points(static_cast<int>(state.range(0)));
+		auto points = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < matrix.rows(); ++i) {
+			points.push_back(matrix.row_vector(i));
+		}
+		for (auto _ : state) {
+			auto centroids = std::vector<comp6771::euclidean_vector>(points.begin(), points.begin() + clusters);
+			for (auto iteration = 0; iteration < iterations; ++iteration) {
+				auto sums = std::vector<comp6771::euclidean_vector>(clusters, comp6771::euclidean_vector(dimensions));
+				auto counts = std::vector<int>(clusters);
+				for (auto const& p : points) {
+					auto best = 0;
+					auto best_distance = std::numeric_limits<double>::infinity();
+					for (auto c = 0; c < clusters; ++c) {
+						auto const distance = comp6771::euclidean_norm(p - centroids[static_cast<std::size_t>(c)]);
+						if (distance < best_distance) {
+							best = c;
+							best_distance = distance;
+						}
+					}
+					sums[static_cast<std::size_t>(best)] += p;
+					++counts[static_cast<std::size_t>(best)];
+				}
+				for (auto c = std::size_t{0}; c < static_cast<std::size_t>(clusters); ++c) {
+					if (counts[c] > 0) {
+						centroids[c] = sums[c] / counts[c];
+					}
+				}
+			}
+			benchmark::DoNotOptimize(centroids.front());
+		}
+		state.SetItemsProcessed(state.iterations() * iterations * state.range(0));
+	}
+	BENCHMARK(bm_hand_written_lloyd)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+} // namespace
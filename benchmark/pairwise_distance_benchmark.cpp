@@ -0,0 +1,56 @@
+// All-pairs distance matrices: the nested loop over euclidean_norm(a - b), which allocates a
+// temporary per pair, against pairwise_distances() writing into one reused buffer, at several
+// thread counts. items_per_second counts distances.
+
+#include "comp6771/euclidean_matrix.hpp"
+#include "random_inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+
+namespace {
+	constexpr auto dimensions = 128;
+
+	// argument: rows in each set
+	void bm_nested_loops(benchmark::State& state) {
+		auto const rows = static_cast<int>(state.range(0));
+		auto const a = random_inputs::random_matrix(rows, dimensions, 1);
+		auto const b = random_inputs::random_matrix(rows, dimensions, 2);
+		auto a_vectors = std::vector<comp6771::euclidean_vector>();
+		auto b_vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto r = 0; r < rows; ++r) {
+			a_vectors.push_back(a.row_vector(r));
+			b_vectors.push_back(b.row_vector(r));
+		}
+		auto out = std::vector<double>(static_cast<std::size_t>(rows) * static_cast<std::size_t>(rows));
+		for (auto _ : state) {
+			auto k = std::size_t{0};
+			for (auto const& x : a_vectors) {
+				for (auto const& y : b_vectors) {
+					out[k++] = comp6771::euclidean_norm(x - y);
+				}
+			}
+			benchmark::DoNotOptimize(out.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+	}
+	BENCHMARK(bm_nested_loops)->Arg(1'000)->Unit(benchmark::kMillisecond);
+
+	// arguments: rows in each set, threads
+	void bm_pairwise_distances(benchmark::State& state) {
+		auto const rows = static_cast<int>(state.range(0));
+		auto const a = random_inputs::random_matrix(rows, dimensions, 1);
+		auto const b = random_inputs::random_matrix(rows, dimensions, 2);
+		auto out = std::vector<double>(static_cast<std::size_t>(rows) * static_cast<std::size_t>(rows));
+		for (auto _ : state) {
+			comp6771::pairwise_distances(a, b, out, static_cast<int>(state.range(1)));
+			benchmark::DoNotOptimize(out.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+	}
+	BENCHMARK(bm_pairwise_distances)
+	   ->ArgsProduct({{1'000, 10'000}, {1, 2, 4, 8}})
+	   ->Unit(benchmark::kMillisecond)
+	   ->UseRealTime();
+} // namespace
@@ -0,0 +1,118 @@
+// Throughput of exact (double) versus approximate (int8) scoring over a corpus, and how much recall
+// the int8 shortlist costs once it is reranked with exact scores.
+//
+// Run with --benchmark_counters_tabular=true to see recall next to the timings.
+
+#include "comp6771/quantised_vector.hpp"
+#include "random_inputs.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+	constexpr auto corpus_size = 20000;
+	constexpr auto dimensions = 256;
+
+	struct fixture {
+		std::vector<comp6771::euclidean_vector> corpus;
+		std::vector<comp6771::quantised_vector> quantised;
+		comp6771::euclidean_vector query;
+		comp6771::quantised_vector quantised_query;
+
+		fixture()
+		: query(dimensions)
+		, quantised_query(query) {
+			auto engine = std::mt19937_64(42); // fixed seed, so every run scores the same data
+			corpus.reserve(corpus_size);
+			quantised.reserve(corpus_size);
+			for (auto i = 0; i < corpus_size; ++i) {
+				corpus.push_back(random_inputs::random_vector(engine, dimensions));
+				quantised.emplace_back(corpus.back());
+			}
+			query = random_inputs::random_vector(engine, dimensions);
+			quantised_query = comp6771::quantised_vector(query);
+		}
+	};
+
+	auto data() -> fixture const& {
+		static auto const instance = fixture();
+		return instance;
+	}
+
+	// indexes of the k best scores, best first
+	auto best_k(std::vector<double> const& scores, std::size_t k) -> std::vector<std::size_t> {
+		auto indexes = std::vector<std::size_t>(scores.size());
+		std::iota(indexes.begin(), indexes.end(), std::size_t{0});
+		std::partial_sort(indexes.begin(),
+		                  indexes.begin() + static_cast<std::ptrdiff_t>(k),
+		                  indexes.end(),
+		                  [&](auto x, auto y) { return scores[x] > scores[y]; });
+		indexes.resize(k);
+		return indexes;
+	}
+
+	void bm_exact_dot(benchmark::State& state) {
+		auto const& d = data();
+		for (auto _ : state) {
+			for (auto const& ev : d.corpus) {
+				benchmark::DoNotOptimize(comp6771::dot(ev, d.query));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * corpus_size);
+		state.SetBytesProcessed(state.iterations() * corpus_size * dimensions
+		                        * static_cast<std::int64_t>(sizeof(double)));
+	}
+
+	void bm_approximate_dot(benchmark::State& state) {
+		auto const& d = data();
+		for (auto _ : state) {
+			for (auto const& q : d.quantised) {
+				benchmark::DoNotOptimize(comp6771::approximate_dot(q, d.quantised_query));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * corpus_size);
+		state.SetBytesProcessed(state.iterations() * corpus_size * dimensions);
+	}
+
+	// shortlist state.range(0) candidates with int8 scores, rerank them exactly, and report how
+	// many of the true top 10 survive
+	void bm_shortlist_and_rerank(benchmark::State& state) {
+		constexpr auto k = std::size_t{10};
+		auto const& d = data();
+		auto const shortlist_size = static_cast<std::size_t>(state.range(0));
+
+		auto exact_scores = std::vector<double>();
+		for (auto const& ev : d.corpus) {
+			exact_scores.push_back(comp6771::dot(ev, d.query));
+		}
+		auto truth = best_k(exact_scores, k);
+		std::sort(truth.begin(), truth.end());
+
+		auto found = std::vector<comp6771::scored_index>();
+		auto approximate_scores = std::vector<double>(corpus_size);
+		for (auto _ : state) {
+			std::transform(d.quantised.begin(),
+			               d.quantised.end(),
+			               approximate_scores.begin(),
+			               [&](auto const& q) { return comp6771::approximate_dot(q, d.quantised_query); });
+			auto const shortlist = best_k(approximate_scores, shortlist_size);
+			found = comp6771::rerank(d.query, d.corpus, shortlist, k);
+			benchmark::DoNotOptimize(found.data());
+		}
+
+		auto const hits = std::count_if(found.begin(), found.end(), [&](auto const& result) {
+			return std::binary_search(truth.begin(), truth.end(), result.index);
+		});
+		state.counters["recall@10"] = static_cast<double>(hits) / static_cast<double>(k);
+		state.SetItemsProcessed(state.iterations() * corpus_size);
+	}
+} // namespace
+
+BENCHMARK(bm_exact_dot);
+BENCHMARK(bm_approximate_dot);
+BENCHMARK(bm_shortlist_and_rerank)->Arg(10)->Arg(50)->Arg(200);
@@ -0,0 +1,56 @@
+#ifndef COMP6771_BENCHMARK_RANDOM_INPUTS_HPP
+#define COMP6771_BENCHMARK_RANDOM_INPUTS_HPP
+
+// Benchmark inputs shared by the benchmarks in this directory: vectors (or matrix rows) of
+// independent standard normal magnitudes, from a fixed seed so every run sees the same data.
+
+#include "comp6771/euclidean_matrix.hpp"
+#include "comp6771/euclidean_vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace random_inputs {
+	inline constexpr auto default_seed = std::uint64_t{6771};
+
+	inline auto fill_normal(std::span<double> const values, std::mt19937_64& engine) -> void {
+		auto distribution = std::normal_distribution<double>(0.0, 1.0);
+		for (auto& x : values) {
+			x = distribution(engine);
+		}
+	}
+
+	// one vector, continuing engine's sequence (for inputs drawn one after another)
+	inline auto random_vector(std::mt19937_64& engine, int const dimensions) -> comp6771::euclidean_vector {
+		auto v = comp6771::euclidean_vector(dimensions);
+		fill_normal(v, engine);
+		return v;
+	}
+
+	inline auto random_vectors(std::size_t const count, int const dimensions, std::uint64_t const seed = default_seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		vectors.reserve(count);
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			vectors.push_back(random_vector(engine, dimensions));
+		}
+		return vectors;
+	}
+
+	// the same values as random_vectors(rows, columns, seed), one per row
+	inline auto random_matrix(int const rows, int const columns, std::uint64_t const seed = default_seed)
+	   -> comp6771::euclidean_matrix {
+		auto engine = std::mt19937_64(seed);
+		auto matrix = comp6771::euclidean_matrix(rows, columns);
+		for (auto r = 0; r < rows; ++r) {
+			fill_normal(matrix.row(r), engine);
+		}
+		return matrix;
+	}
+} // namespace random_inputs
+
+#endif // COMP6771_BENCHMARK_RANDOM_INPUTS_HPP
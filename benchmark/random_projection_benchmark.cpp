@@ -0,0 +1,66 @@
+// Random projection from 10^4 down to 256 dimensions: the cost of generating each kind of matrix,
+// of projecting batches (at several thread counts), and what it buys downstream, a dot product
+// between two projected vectors against one between the originals.
+
+#include "comp6771/random_projection.hpp"
+#include "random_inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+namespace {
+	constexpr auto input = 10'000;
+	constexpr auto output = 256;
+
+	auto make_batch(int const rows) -> comp6771::euclidean_matrix {
+		return random_inputs::random_matrix(rows, input);
+	}
+
+	// argument: 0 gaussian, 1 sparse
+	void bm_generate(benchmark::State& state) {
+		auto const kind = state.range(0) == 0 ? comp6771::projection_kind::gaussian
+		                                      : comp6771::projection_kind::sparse;
+		for (auto _ : state) {
+			auto const projection = comp6771::random_projection(input, output, kind, 1);
+			benchmark::DoNotOptimize(projection.matrix()(0, 0));
+		}
+	}
+	BENCHMARK(bm_generate)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+	void bm_project_vector(benchmark::State& state) {
+		auto const projection = comp6771::random_projection(input, output);
+		auto const v = make_batch(1).row_vector(0);
+		for (auto _ : state) {
+			auto const projected = projection(v);
+			benchmark::DoNotOptimize(projected[0]);
+		}
+	}
+	BENCHMARK(bm_project_vector)->Unit(benchmark::kMicrosecond);
+
+	// arguments: batch size, threads
+	void bm_project_batch(benchmark::State& state) {
+		auto const projection = comp6771::random_projection(input, output);
+		auto const batch = make_batch(static_cast<int>(state.range(0)));
+		auto const threads = static_cast<int>(state.range(1));
+		for (auto _ : state) {
+			auto const projected = projection(batch, threads);
+			benchmark::DoNotOptimize(projected(0, 0));
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(bm_project_batch)
+	   ->ArgsProduct({{1'000}, {1, 2, 4, 8}})
+	   ->Unit(benchmark::kMillisecond)
+	   ->UseRealTime();
+
+	// argument: dimensions of the vectors dotted
+	void bm_downstream_dot(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const a = comp6771::euclidean_vector(dimensions, 0.5);
+		auto const b = comp6771::euclidean_vector(dimensions, 0.25);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(a, b, comp6771::unchecked));
+		}
+	}
+	BENCHMARK(bm_downstream_dot)->Arg(input)->Arg(output);
+} // namespace
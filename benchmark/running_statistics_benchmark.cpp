@@ -0,0 +1,65 @@
+// Running mean and variance of a stream of vectors: the operator+ / operator* way, which
+// allocates temporaries per sample, against running_statistics::add() one sample at a time and in
+// batches on several threads. items_per_second counts samples.
+
+#include "comp6771/running_statistics.hpp"
+#include "random_inputs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+
+namespace {
+	constexpr auto samples = 100'000;
+
+	// argument: dimensions
+	void bm_operators(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const vectors = random_inputs::random_vectors(samples, dimensions);
+		for (auto _ : state) {
+			auto sum = comp6771::euclidean_vector(dimensions);
+			auto sum_of_squares = comp6771::euclidean_vector(dimensions);
+			for (auto const& v : vectors) {
+				sum = sum + v;
+				auto squared = v;
+				squared.transform(v, [](double x, double y) { return x * y; });
+				sum_of_squares = sum_of_squares + squared;
+			}
+			auto const mean = sum / samples;
+			benchmark::DoNotOptimize(mean.data());
+			benchmark::DoNotOptimize(sum_of_squares.data());
+		}
+		state.SetItemsProcessed(state.iterations() * samples);
+	}
+	BENCHMARK(bm_operators)->Arg(128)->Unit(benchmark::kMillisecond);
+
+	// arguments: dimensions, covariance
+	void bm_add(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const vectors = random_inputs::random_vectors(samples, dimensions);
+		auto statistics = comp6771::running_statistics(dimensions, state.range(1) != 0);
+		for (auto _ : state) {
+			statistics.reset();
+			for (auto const& v : vectors) {
+				statistics.add(v);
+			}
+			benchmark::DoNotOptimize(statistics.mean().data());
+		}
+		state.SetItemsProcessed(state.iterations() * samples);
+	}
+	BENCHMARK(bm_add)->Args({128, 0})->Args({128, 1})->Unit(benchmark::kMillisecond);
+
+	// arguments: dimensions, threads
+	void bm_add_batch(benchmark::State& state) {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const matrix = random_inputs::random_matrix(samples, dimensions);
+		auto statistics = comp6771::running_statistics(dimensions);
+		for (auto _ : state) {
+			statistics.reset();
+			statistics.add(matrix, static_cast<int>(state.range(1)));
+			benchmark::DoNotOptimize(statistics.mean().data());
+		}
+		state.SetItemsProcessed(state.iterations() * samples);
+	}
+	BENCHMARK(bm_add_batch)->Args({128, 1})->Args({128, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+} // namespace
@@ -0,0 +1,52 @@
+// The k best dot scores against a query: scoring everything into a vector and sorting it, against
+// top_k_by_dot() keeping bounded per-thread heaps, at several thread counts. items_per_second
+// counts scored vectors.
+
+#include "comp6771/top_k.hpp"
+#include "random_inputs.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+
+namespace {
+	constexpr auto dimensions = 32;
+	constexpr auto k = std::size_t{10};
+
+	// argument: vectors
+	void bm_full_sort(benchmark::State& state) {
+		auto const vectors = random_inputs::random_vectors(static_cast<std::size_t>(state.range(0)), dimensions);
+		auto const& query = vectors.front();
+		for (auto _ : state) {
+			auto scored = std::vector<comp6771::scored_index>();
+			scored.reserve(vectors.size());
+			for (auto i = std::size_t{0}; i < vectors.size(); ++i) {
+				scored.push_back({i, comp6771::dot(vectors[i], query)});
+			}
+			std::sort(scored.begin(), scored.end(), [](auto const& a, auto const& b) { return a.score > b.score; });
+			scored.resize(k);
+			benchmark::DoNotOptimize(scored.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(bm_full_sort)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+	// arguments: vectors, threads
+	void bm_top_k_by_dot(benchmark::State& state) {
+		auto const vectors = random_inputs::random_vectors(static_cast<std::size_t>(state.range(0)), dimensions);
+		auto const& query = vectors.front();
+		for (auto _ : state) {
+			auto result = comp6771::top_k_by_dot(query, vectors, k, static_cast<int>(state.range(1)));
+			benchmark::DoNotOptimize(result.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(bm_top_k_by_dot)
+	   ->Args({1'000'000, 1})
+	   ->Args({1'000'000, 2})
+	   ->Args({1'000'000, 4})
+	   ->Args({1'000'000, 8})
+	   ->Unit(benchmark::kMillisecond)
+	   ->UseRealTime();
+} // namespace
@@ -0,0 +1,122 @@
+#ifndef COMP6771_EUCLIDEAN_MATRIX_HPP
+#define COMP6771_EUCLIDEAN_MATRIX_HPP
+
+// Dense, row-major matrix of doubles that works with euclidean_vector. Each row is stored
+// contiguously, so a matrix also doubles as compact batch storage for many vectors of the same
+// dimension (row i is one vector). Rows get the same storage guarantees as euclidean_vector:
+// every row starts on a cache line and is zero-padded to a whole number of cache lines.
+
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	class euclidean_matrix {
+	public:
+		// constructors (same int-for-sizes convention as euclidean_vector)
+		euclidean_matrix(int, int); // rows, columns; all zero
+		euclidean_matrix(int, int, double); // rows, columns, fill value
+		euclidean_matrix(int, int, std::initializer_list<double>); // values given row by row
+		explicit euclidean_matrix(std::span<euclidean_vector const>); // one row per vector
+		euclidean_matrix(euclidean_matrix const&);
+		euclidean_matrix(euclidean_matrix&&) noexcept;
+
+		~euclidean_matrix() noexcept = default;
+
+		auto operator=(euclidean_matrix const&) -> euclidean_matrix&;
+		auto operator=(euclidean_matrix&&) noexcept -> euclidean_matrix&;
+
+		auto operator()(int, int) const -> double; // row, column; asserts on bad indexes
+		auto operator()(int, int) -> double&;
+
+		[[nodiscard]] auto rows() const noexcept -> int;
+		[[nodiscard]] auto columns() const noexcept -> int;
+
+		// direct views on a row, for handing one vector of a batch to other code without copying
+		[[nodiscard]] auto row(int) const -> std::span<double const>;
+		auto row(int) -> std::span<double>;
+		[[nodiscard]] auto row_vector(int) const -> euclidean_vector; // copy of one row
+
+		friend auto operator==(euclidean_matrix const&, euclidean_matrix const&) -> bool;
+		friend auto operator<<(std::ostream&, euclidean_matrix const&) -> std::ostream&;
+
+	private:
+		detail::aligned_array values_;
+		std::size_t rows_;
+		std::size_t columns_;
+		std::size_t stride_; // distance between the starts of two rows: columns_ plus padding
+
+		// a row including its zero padding, for kernels that want full-width loads without a tail
+		[[nodiscard]] auto padded_row(std::size_t) const noexcept -> std::span<double const>;
+		auto padded_row(std::size_t) noexcept -> std::span<double>;
+
+		friend auto multiply(euclidean_matrix const&, euclidean_vector const&, int)
+		   -> euclidean_vector;
+		friend auto multiply(euclidean_matrix const&, euclidean_matrix const&, int)
+		   -> euclidean_matrix;
+		friend auto multiply_transposed(euclidean_matrix const&, euclidean_matrix const&, int)
+		   -> euclidean_matrix;
+		friend auto gram(euclidean_matrix const&, euclidean_matrix const&, std::span<double>, int)
+		   -> void;
+		friend auto pairwise_distances(euclidean_matrix const&, euclidean_matrix const&, std::span<double>, int)
+		   -> void;
+		friend auto
+		pairwise_squared_distances(euclidean_matrix const&, euclidean_matrix const&, std::span<double>, int)
+		   -> void;
+	};
+
+	// Products. All of them check dimensions and throw euclidean_vector_error on a mismatch.
+	// `threads` splits the output rows between that many threads; anything below 1 uses every
+	// hardware thread. The operator forms are single-threaded.
+
+	// matrix-vector product (one dot product per row), blocked so each slice of the input vector
+	// is reused by several rows while it is still in cache
+	auto multiply(euclidean_matrix const&, euclidean_vector const&, int threads) -> euclidean_vector;
+	auto operator*(euclidean_matrix const&, euclidean_vector const&) -> euclidean_vector;
+
+	// matrix-matrix product, cache-blocked
+	auto multiply(euclidean_matrix const&, euclidean_matrix const&, int threads) -> euclidean_matrix;
+	auto operator*(euclidean_matrix const&, euclidean_matrix const&) -> euclidean_matrix;
+
+	// a * transpose(b). With a batch of vectors as the rows of `a` and weights as the rows of `b`,
+	// this projects the whole batch at once: result(i, j) = dot(a row i, b row j)
+	auto multiply_transposed(euclidean_matrix const&, euclidean_matrix const&, int threads)
+	   -> euclidean_matrix;
+
+	// The same product written into a caller-provided buffer, for results too big to allocate per
+	// call (100k x 100k is 80 GB): out is row-major with b.rows() columns, out[i * b.rows() + j] =
+	// dot(a row i, b row j). Throws euclidean_vector_error if a and b have different columns or
+	// out isn't exactly a.rows() * b.rows() long
+	auto gram(euclidean_matrix const& a, euclidean_matrix const& b, std::span<double> out, int threads = 1)
+	   -> void;
+
+	// Euclidean distance between every row of a and every row of b, into out laid out as for
+	// gram(). Worked out as ||a||^2 + ||b||^2 - 2 a.b on top of the same tiled kernel, so no
+	// difference vectors are formed. That loses precision for rows much closer together than their
+	// norms (the error is around 1e-8 times the norms, rather than the distance): centre the data,
+	// or recheck close pairs with euclidean_norm(a - b), if that matters. Distances from a matrix
+	// to itself have an exactly zero diagonal
+	auto pairwise_distances(euclidean_matrix const& a,
+	                        euclidean_matrix const& b,
+	                        std::span<double> out,
+	                        int threads = 1) -> void;
+	// the same, without the square roots (for nearest-neighbour ranking, which doesn't need them)
+	auto pairwise_squared_distances(euclidean_matrix const& a,
+	                                euclidean_matrix const& b,
+	                                std::span<double> out,
+	                                int threads = 1) -> void;
+
+	// normalise() for a batch stored as matrix rows: each row becomes its unit vector, in place,
+	// with the rows split between `threads` threads (below 1 means every hardware thread). Rows with
+	// a zero norm (or every row, if there are no columns) are left unchanged and their indexes
+	// returned in ascending order
+	auto normalise_rows(euclidean_matrix&, int threads = 1) -> std::vector<std::size_t>;
+
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_MATRIX_HPP
@@ -1,18 +1,28 @@
 #ifndef COMP6771_EUCLIDEAN_VECTOR_HPP
 #define COMP6771_EUCLIDEAN_VECTOR_HPP
 
+#include <cassert>
 #include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <ostream>
 #include <range/v3/algorithm.hpp>
 #include <range/v3/iterator.hpp>
+#include <range/v3/range/concepts.hpp>
+#include <range/v3/range/primitives.hpp>
+#include <range/v3/view/subrange.hpp>
 #include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace comp6771 {
@@ -22,20 +32,162 @@ namespace comp6771 {
 		: std::runtime_error(what) {}
 	};
 
+	class euclidean_matrix;
+	class quantised_vector;
+
+	// how euclidean_norm() computes the norm
+	enum class norm_mode {
+		fast, // sqrt(dot(v, v)): overflows to inf for magnitudes above about 1e154, and underflows to
+		      // 0 below about 1e-154
+		scaled, // same result as fast when that is safe, otherwise rescales by a power of two so
+		        // extreme magnitudes neither overflow nor underflow
+	};
+
+	namespace detail {
+		// Cache-line aligned, zero-padded double buffers, used for euclidean_vector storage and the
+		// rows of euclidean_matrix
+		inline constexpr auto storage_alignment = std::size_t{64};
+		inline constexpr auto storage_lanes = storage_alignment / sizeof(double);
+
+		// count rounded up to a whole number of cache lines
+		constexpr auto padded_size(std::size_t const count) noexcept -> std::size_t {
+			return (count + storage_lanes - 1) / storage_lanes * storage_lanes;
+		}
+
+		struct aligned_delete {
+			auto operator()(double*) const noexcept -> void;
+		};
+
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		using aligned_array = std::unique_ptr<double[], aligned_delete>;
+
+		// euclidean_norm(v, norm_mode::scaled) on a non-empty span of magnitudes, for code that
+		// keeps magnitudes outside a euclidean_vector (such as euclidean_matrix rows)
+		auto scaled_norm(std::span<double const>) -> double;
+
+		// room for padded_size(count) doubles, starting on a storage_alignment boundary. Elements
+		// [0, count) are left for the caller to fill; the padding after them is zeroed
+		auto make_aligned_array(std::size_t count) -> aligned_array;
+
+		// Reference-counted version of aligned_array, for euclidean_vector storage that copies can
+		// share (see euclidean_vector::share_on_copy). The count lives in its own cache line just in
+		// front of the magnitudes, so there is still one allocation per buffer and the magnitudes
+		// keep the storage guarantees above
+		class shared_aligned_array {
+		public:
+			shared_aligned_array() noexcept = default;
+			// same contract as make_aligned_array. huge_pages: see allocation_policy
+			explicit shared_aligned_array(std::size_t count, bool huge_pages = false);
+			shared_aligned_array(shared_aligned_array const&) noexcept;
+			shared_aligned_array(shared_aligned_array&&) noexcept;
+			~shared_aligned_array() noexcept;
+
+			auto operator=(shared_aligned_array const&) noexcept -> shared_aligned_array&;
+			auto operator=(shared_aligned_array&&) noexcept -> shared_aligned_array&;
+
+			[[nodiscard]] auto get() const noexcept -> double* { return magnitudes_; }
+			auto operator[](std::size_t const i) const noexcept -> double& { return magnitudes_[i]; }
+
+			// true when no other array refers to the same storage (and for an empty array)
+			[[nodiscard]] auto unique() const noexcept -> bool;
+			[[nodiscard]] auto huge_pages() const noexcept -> bool; // allocated on huge pages
+
+		private:
+			auto release() noexcept -> void;
+
+			double* magnitudes_ = nullptr;
+		};
+	} // namespace detail
+
+	// Where the storage of a very large vector comes from (euclidean_vector(int, double,
+	// allocation_policy)). Only matters for vectors of many MB; small ones ignore it
+	struct allocation_policy {
+		// back the storage with transparent huge pages (Linux madvise, a hint the kernel may
+		// ignore), cutting TLB misses for multi-GB vectors. Copies of the vector inherit it
+		bool huge_pages = false;
+
+		// fill the new vector from this many threads (below 1 means every hardware thread). Pages
+		// are placed on the NUMA node of the thread that first touches them, so this spreads the
+		// vector over the nodes those threads run on instead of putting it all on the caller's.
+		// Most useful when the vector is later processed with the same number of threads
+		int first_touch_threads = 1;
+	};
+
+	// element-wise functions accepted by euclidean_vector::transform(), map() and zip_with()
+	template<typename Fn>
+	concept magnitude_map = std::regular_invocable<Fn&, double>
+	                        and std::convertible_to<std::invoke_result_t<Fn&, double>, double>;
+	template<typename Fn>
+	concept magnitude_zip = std::regular_invocable<Fn&, double, double>
+	                        and std::convertible_to<std::invoke_result_t<Fn&, double, double>, double>;
+
+	// tag selecting the unchecked overloads (euclidean_vector::add(x, unchecked) and so on), in the
+	// style of std::nothrow
+	struct unchecked_t {
+		explicit unchecked_t() = default;
+	};
+	inline constexpr auto unchecked = unchecked_t{};
+
+	// everything euclidean_vector::summarise() works out in its single pass
+	struct summary_statistics {
+		double sum;
+		double min;
+		double max;
+		int argmin; // index of the first occurrence of min
+		int argmax; // index of the first occurrence of max
+		double mean;
+		double variance; // population variance (divides by the number of dimensions)
+	};
+
 	class euclidean_vector {
 	public:
+		// Storage guarantees, for kernels working on the buffer directly: the magnitudes start on a
+		// cache-line (storage_alignment byte) boundary, and the buffer is zero-padded up to a
+		// multiple of storage_lanes doubles. So full-width aligned loads never split a cache line
+		// and need no scalar tail
+		static constexpr auto storage_alignment = detail::storage_alignment;
+		static constexpr auto storage_lanes = detail::storage_lanes;
+
 		// constructors
 		euclidean_vector() ;
 		explicit euclidean_vector(int); // explicit only in function declaration
 		euclidean_vector(int, double); // const arguments only in fn definition
+		euclidean_vector(int, double, allocation_policy);
 		euclidean_vector(std::vector<double>::const_iterator,
 		                 std::vector<double>::const_iterator);
 		euclidean_vector(std::initializer_list<double>) noexcept;
+
+		// generic range and iterator-pair constructors. Take anything whose elements convert to
+		// double (std::array, std::span, raw buffers, float data, views), so callers no longer have
+		// to copy into a std::vector<double> first. Contiguous double sources are one memcpy
+		template<typename Range>
+		requires ranges::input_range<Range> and std::convertible_to<ranges::range_value_t<Range>, double>
+		         and (not std::same_as<std::remove_cvref_t<Range>, euclidean_vector>)
+		explicit euclidean_vector(Range&& range);
+		template<ranges::input_iterator Iterator, ranges::sentinel_for<Iterator> Sentinel>
+		requires std::convertible_to<ranges::iter_value_t<Iterator>, double>
+		euclidean_vector(Iterator first, Sentinel last)
+		: euclidean_vector(ranges::subrange<Iterator, Sentinel>(first, last)) {}
+
 		euclidean_vector(euclidean_vector const&) noexcept; // copy constructor
 		euclidean_vector(euclidean_vector&&) noexcept; // move constructor
 
 		~euclidean_vector() noexcept = default; // destructor, explicitly declared as default (spec)
 
+		// Copy-on-write. After share_on_copy(true), copies of this vector share its storage rather
+		// than duplicating it, so copying is O(1) whatever the dimensions. A vector that shares its
+		// storage duplicates it the first time it is modified (non-const [] and at(), compound and
+		// fused operators, transform()). Copies inherit the setting. Off by default, since while it
+		// is on a reference returned by non-const [] or at() is only good until the vector is next
+		// copied, and every one of those calls checks whether the storage is shared. Vectors sharing
+		// storage may be used from different threads, as with std::shared_ptr
+		auto share_on_copy(bool) -> euclidean_vector&;
+		[[nodiscard]] auto shares_on_copy() const noexcept -> bool;
+		[[nodiscard]] auto shares_storage_with(euclidean_vector const&) const noexcept -> bool;
+
+		// whether the storage is on huge pages (see allocation_policy)
+		[[nodiscard]] auto uses_huge_pages() const noexcept -> bool;
+
 		auto operator=(euclidean_vector const&) -> euclidean_vector&; // copy assignment
 		auto operator=(euclidean_vector&&) noexcept -> euclidean_vector&; // move assignment
 		auto operator[](int) const -> double; // to read value
@@ -48,6 +200,57 @@ namespace comp6771 {
 		auto operator*=(double) -> euclidean_vector&;
 		auto operator/=(double) -> euclidean_vector&;
 
+		// in-place fused (BLAS-1 style) updates. None of these allocate, unlike y += alpha * x,
+		// which builds a scaled temporary first
+		auto axpy(double, euclidean_vector const&) -> euclidean_vector&; // this += alpha * x
+		auto axpby(double, euclidean_vector const&, double) -> euclidean_vector&; // this = alpha * x +
+		                                                                          // beta * this
+		auto lerp(euclidean_vector const&, double) -> euclidean_vector&; // this += t * (x - this)
+		auto fma(euclidean_vector const&, euclidean_vector const&) -> euclidean_vector&; // this += a*b
+
+		// Unchecked fast paths, for tight loops where the dimensions are equal by construction. They
+		// skip the dimension check, and with it all exception handling: the dimensions are only
+		// assert()ed, and mismatched dimensions are undefined behaviour. divide() doesn't check for
+		// zero either (x / 0 gives inf or nan, as for doubles). Nor do they detach copy-on-write
+		// storage, which would put a branch (and a possible allocation) back in: the storage must not
+		// be shared when they are called (also only assert()ed). It never is with share_on_copy off;
+		// with it on, call non-const data() first to give the vector a buffer of its own. Defined
+		// inline below, so for small vectors the whole update can be inlined into the caller's loop
+		auto add(euclidean_vector const&, unchecked_t) noexcept -> euclidean_vector&; // +=
+		auto subtract(euclidean_vector const&, unchecked_t) noexcept -> euclidean_vector&; // -=
+		auto divide(double, unchecked_t) noexcept -> euclidean_vector&; // /=
+		auto axpy(double, euclidean_vector const&, unchecked_t) noexcept -> euclidean_vector&;
+
+		// in-place element-wise functions: this[i] = fn(this[i]), or fn(this[i], other[i]). A
+		// single ranges::transform over the storage, so a simple fn (or an inlined lambda)
+		// vectorises. The zip form throws euclidean_vector_error on mismatched dimensions
+		template<magnitude_map UnaryFn>
+		auto transform(UnaryFn fn) -> euclidean_vector&;
+		template<magnitude_zip BinaryFn>
+		auto transform(euclidean_vector const&, BinaryFn fn) -> euclidean_vector&;
+
+		// Contiguous range interface, so standard and range-v3 algorithms run straight on the
+		// storage (euclidean_vector models contiguous_range and sized_range). The iterators are
+		// plain pointers into the magnitudes. The non-const overloads detach copy-on-write storage
+		// first, like non-const [], and likewise their pointers are only good until the vector is
+		// next copied while share_on_copy is on. Detaching allocates, so unlike the const overloads
+		// they aren't noexcept
+		using value_type = double;
+		using iterator = double*;
+		using const_iterator = double const*;
+
+		[[nodiscard]] auto data() -> double*;
+		[[nodiscard]] auto data() const noexcept -> double const*;
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+		auto begin() -> iterator;
+		auto end() -> iterator;
+		[[nodiscard]] auto begin() const noexcept -> const_iterator;
+		[[nodiscard]] auto end() const noexcept -> const_iterator;
+
+		// in-place unit(): divides every magnitude by the norm, giving exactly unit(*this) without
+		// allocating. Throws euclidean_vector_error like unit() (no dimensions, or a zero norm)
+		auto normalise() -> euclidean_vector&;
+
 		// type conversions
 		explicit operator std::vector<double>() const noexcept;
 		explicit operator std::list<double>() const noexcept;
@@ -58,6 +261,30 @@ namespace comp6771 {
 		auto at(int) -> double&;
 		[[nodiscard]] auto dimensions() const noexcept -> int;
 
+		// reductions over the magnitudes, straight from the storage. All except sum() throw
+		// euclidean_vector_error for a vector with no dimensions. Each is a single pass;
+		// summarise() gets all of them from one pass, optionally split between threads (below 1
+		// means every hardware thread)
+		[[nodiscard]] auto sum() const noexcept -> double;
+		[[nodiscard]] auto min() const -> double;
+		[[nodiscard]] auto max() const -> double;
+		[[nodiscard]] auto argmin() const -> int;
+		[[nodiscard]] auto argmax() const -> int;
+		[[nodiscard]] auto mean() const -> double;
+		[[nodiscard]] auto variance() const -> double;
+		[[nodiscard]] auto summarise(int threads = 1) const -> summary_statistics;
+
+		// 64-bit hash of the dimensions and magnitudes. Equal vectors (operator==) hash equal, so
+		// -0.0 and 0.0 hash the same. Built from four independent mixing lanes over the raw
+		// storage, so it runs at close to memory speed
+		[[nodiscard]] auto content_hash() const noexcept -> std::uint64_t;
+
+		// lets euclidean_vector be a key in absl hash containers (absl::Hash finds it via ADL)
+		template<typename H>
+		friend auto AbslHashValue(H state, euclidean_vector const& v) -> H { // NOLINT(readability-identifier-naming)
+			return H::combine(std::move(state), v.content_hash());
+		}
+
 		// Friend functions
 
 		friend auto operator==(euclidean_vector const&, euclidean_vector const&) -> bool;
@@ -72,10 +299,52 @@ namespace comp6771 {
 		friend auto operator/(euclidean_vector const&, double) -> euclidean_vector;
 		friend auto operator<<(std::ostream&, euclidean_vector const&) -> std::ostream&;
 
+		// matrix and quantisation code (euclidean_matrix.hpp, quantised_vector.hpp) read and write
+		// vectors in bulk, so they get direct access to the storage like the friends above
+		friend class euclidean_matrix;
+		friend class quantised_vector;
+		friend auto multiply(euclidean_matrix const&, euclidean_vector const&, int) -> euclidean_vector;
+
+		friend auto euclidean_norm(euclidean_vector const&, norm_mode) -> double;
+		friend auto dot(euclidean_vector const&, euclidean_vector const&, unchecked_t) noexcept
+		   -> double;
+		friend auto reproducible_sum(euclidean_vector const&, int) -> double;
+		friend auto reproducible_dot(euclidean_vector const&, euclidean_vector const&, int) -> double;
+		friend auto reproducible_norm(euclidean_vector const&, int) -> double;
+
+		// out-of-place versions of transform(): write fn's results straight into new storage, with
+		// no intermediate copy of the input
+		template<magnitude_map UnaryFn>
+		friend auto map(euclidean_vector const&, UnaryFn) -> euclidean_vector;
+		template<magnitude_zip BinaryFn>
+		friend auto zip_with(euclidean_vector const&, euclidean_vector const&, BinaryFn)
+		   -> euclidean_vector;
+
 	private:
-		// ass2 spec requires we use pointers to double[] instead of std::vector
-		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-		std::unique_ptr<double[]> magnitudes_;
+		// allocates storage for the given number of dimensions without filling it, for
+		// constructors that overwrite every element straight away
+		auto allocate(std::size_t, bool huge_pages = false) -> void;
+
+		// constructs with allocate(), for friends that write every element themselves
+		struct uninitialised_tag {};
+		euclidean_vector(std::size_t, uninitialised_tag);
+
+		// called before every write to the storage: gives this vector a buffer of its own if it is
+		// currently sharing one (see share_on_copy). Only a flag test when sharing is off
+		auto detach() -> void {
+			if (share_on_copy_ and not magnitudes_.unique()) {
+				unshare();
+			}
+		}
+		auto unshare() -> void; // the copying half of detach()
+
+		// throws euclidean_vector_error if the two vectors' dimensions differ
+		static auto check_dimensions(euclidean_vector const&, euclidean_vector const&) -> void;
+
+		// ass2 spec requires we use pointers to double[] instead of std::vector. Still an owning
+		// pointer to double[], just with an aligned allocation (see the storage guarantees above)
+		// and a reference count, so copy-on-write copies can share it
+		detail::shared_aligned_array magnitudes_;
 
 		// size_t is the default value for size types. But spec requires dimensions to be passed as
 		// int in constructors, using casts as required. dimensions() also returns int. Declaring
@@ -83,16 +352,193 @@ namespace comp6771 {
 		// in the code
 		std::size_t dimensions_;
 
+		bool share_on_copy_ = false;
+
 		// tested that norm algorithm is efficient and calculates norm of million element vector in a
 		// few milliseconds, so not using norm caching, as it was adding unnecessary complexity and
 		// potential for unknown bugs (without knowing enough test cases)
 	};
 
+	template<typename Range>
+	requires ranges::input_range<Range> and std::convertible_to<ranges::range_value_t<Range>, double>
+	         and (not std::same_as<std::remove_cvref_t<Range>, euclidean_vector>)
+	euclidean_vector::euclidean_vector(Range&& range) {
+		if constexpr (ranges::forward_range<Range> or ranges::sized_range<Range>) {
+			allocate(static_cast<std::size_t>(ranges::distance(range)));
+			auto magnitude_span = std::span<double>(magnitudes_.get(), dimensions_);
+			if constexpr (ranges::contiguous_range<Range>
+			              and std::same_as<ranges::range_value_t<Range>, double>)
+			{
+				if (not magnitude_span.empty()) { // data() may be null for empty sources
+					std::memcpy(magnitude_span.data(), ranges::data(range), magnitude_span.size_bytes());
+				}
+			}
+			else {
+				ranges::copy(range, magnitude_span.begin()); // converts element type as it goes
+			}
+		}
+		else {
+			// single-pass input (e.g. a stream view) can't be measured without consuming it, so it
+			// has to be buffered once
+			auto buffer = std::vector<double>();
+			ranges::copy(range, std::back_inserter(buffer));
+			allocate(buffer.size());
+			if (not buffer.empty()) {
+				std::memcpy(magnitudes_.get(), buffer.data(), buffer.size() * sizeof(double));
+			}
+		}
+	}
+
+	template<magnitude_map UnaryFn>
+	auto euclidean_vector::transform(UnaryFn fn) -> euclidean_vector& {
+		detach();
+		auto const magnitude_span = std::span<double>(magnitudes_.get(), dimensions_);
+		ranges::transform(magnitude_span, magnitude_span.begin(), fn);
+		return *this;
+	}
+
+	template<magnitude_zip BinaryFn>
+	auto euclidean_vector::transform(euclidean_vector const& other, BinaryFn fn) -> euclidean_vector& {
+		check_dimensions(*this, other);
+		detach();
+		auto const magnitude_span = std::span<double>(magnitudes_.get(), dimensions_);
+		auto const other_span = std::span<double const>(other.magnitudes_.get(), other.dimensions_);
+		ranges::transform(magnitude_span, other_span, magnitude_span.begin(), fn);
+		return *this;
+	}
+
+	// range interface, inline so iterating costs nothing over using a pointer
+
+	inline auto euclidean_vector::data() -> double* {
+		detach();
+		return magnitudes_.get();
+	}
+
+	inline auto euclidean_vector::data() const noexcept -> double const* {
+		return magnitudes_.get();
+	}
+
+	inline auto euclidean_vector::size() const noexcept -> std::size_t {
+		return dimensions_;
+	}
+
+	inline auto euclidean_vector::begin() -> iterator {
+		return data();
+	}
+
+	inline auto euclidean_vector::end() -> iterator {
+		return data() + dimensions_;
+	}
+
+	inline auto euclidean_vector::begin() const noexcept -> const_iterator {
+		return data();
+	}
+
+	inline auto euclidean_vector::end() const noexcept -> const_iterator {
+		return data() + dimensions_;
+	}
+
+	// the unchecked overloads write straight to the storage, which must already be this vector's
+	// own (see the precondition above)
+
+	inline auto euclidean_vector::add(euclidean_vector const& x, unchecked_t) noexcept
+	   -> euclidean_vector& {
+		assert(dimensions_ == x.dimensions_);
+		assert(not share_on_copy_ or magnitudes_.unique());
+		auto const y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		ranges::transform(y_span,
+		                  std::span<double const>(x.magnitudes_.get(), dimensions_),
+		                  y_span.begin(),
+		                  std::plus<>());
+		return *this;
+	}
+
+	inline auto euclidean_vector::subtract(euclidean_vector const& x, unchecked_t) noexcept
+	   -> euclidean_vector& {
+		assert(dimensions_ == x.dimensions_);
+		assert(not share_on_copy_ or magnitudes_.unique());
+		auto const y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		ranges::transform(y_span,
+		                  std::span<double const>(x.magnitudes_.get(), dimensions_),
+		                  y_span.begin(),
+		                  std::minus<>());
+		return *this;
+	}
+
+	inline auto euclidean_vector::divide(double const scalar, unchecked_t) noexcept
+	   -> euclidean_vector& {
+		assert(not share_on_copy_ or magnitudes_.unique());
+		auto const y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		ranges::transform(y_span, y_span.begin(), [scalar](double const y) { return y / scalar; });
+		return *this;
+	}
+
+	inline auto euclidean_vector::axpy(double const alpha, euclidean_vector const& x, unchecked_t) noexcept
+	   -> euclidean_vector& {
+		assert(dimensions_ == x.dimensions_);
+		assert(not share_on_copy_ or magnitudes_.unique());
+		auto const y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		ranges::transform(y_span,
+		                  std::span<double const>(x.magnitudes_.get(), dimensions_),
+		                  y_span.begin(),
+		                  [alpha](double const y, double const xi) { return y + alpha * xi; });
+		return *this;
+	}
+
+	template<magnitude_map UnaryFn>
+	auto map(euclidean_vector const& v, UnaryFn fn) -> euclidean_vector {
+		auto result = euclidean_vector(v.dimensions_, euclidean_vector::uninitialised_tag{});
+		ranges::transform(std::span<double const>(v.magnitudes_.get(), v.dimensions_),
+		                  result.magnitudes_.get(),
+		                  fn);
+		return result;
+	}
+
+	template<magnitude_zip BinaryFn>
+	auto zip_with(euclidean_vector const& lhs, euclidean_vector const& rhs, BinaryFn fn)
+	   -> euclidean_vector {
+		euclidean_vector::check_dimensions(lhs, rhs);
+		auto result = euclidean_vector(lhs.dimensions_, euclidean_vector::uninitialised_tag{});
+		ranges::transform(std::span<double const>(lhs.magnitudes_.get(), lhs.dimensions_),
+		                  std::span<double const>(rhs.magnitudes_.get(), rhs.dimensions_),
+		                  result.magnitudes_.get(),
+		                  fn);
+		return result;
+	}
+
+	// common element-wise functions, built on map() and zip_with()
+	auto hadamard(euclidean_vector const&, euclidean_vector const&) -> euclidean_vector; // a[i]*b[i]
+	auto abs(euclidean_vector const&) -> euclidean_vector;
+	auto clamp(euclidean_vector const&, double low, double high) -> euclidean_vector;
+
 	// Utility functions
 
 	auto euclidean_norm(euclidean_vector const& v) -> double;
+	auto euclidean_norm(euclidean_vector const& v, norm_mode) -> double;
 	auto unit(euclidean_vector const&) -> euclidean_vector;
+
+	// Batched normalise(): normalises every vector in place, split between `threads` threads (below
+	// 1 means every hardware thread). Rather than throwing, vectors that can't be normalised (no
+	// dimensions, or a zero norm) are left unchanged and their indexes returned, in ascending
+	// order. See normalise_rows() in euclidean_matrix.hpp for a contiguous batch
+	auto normalise(std::span<euclidean_vector>, int threads = 1) -> std::vector<std::size_t>;
 	auto dot(euclidean_vector const&, euclidean_vector const&) -> double;
+	// unchecked dot (see euclidean_vector::add(x, unchecked)): no dimension check, so no exceptions,
+	// and it reads the storage directly instead of copying it. Gives 0 for empty vectors
+	auto dot(euclidean_vector const&, euclidean_vector const&, unchecked_t) noexcept -> double;
+
+	// Bit-reproducible reductions. The same inputs give bitwise identical results whatever the
+	// number of threads (below 1 means every hardware thread) and whatever SIMD width the library
+	// was built for, so they suit regression diffs and cross-host checks. Each block of
+	// reproducible_block magnitudes is reduced with a fixed four-lane kernel, and the block results
+	// are added in a fixed pairwise tree; threads only decide who computes which blocks.
+	// reproducible_norm() also rescales like norm_mode::scaled when the plain sum of squares would
+	// overflow or underflow. Throws like sum(), dot() and euclidean_norm() do
+	inline constexpr auto reproducible_block = std::size_t{4096};
+	auto reproducible_sum(euclidean_vector const&, int threads = 1) -> double;
+	auto reproducible_dot(euclidean_vector const&, euclidean_vector const&, int threads = 1)
+	   -> double;
+	auto reproducible_norm(euclidean_vector const&, int threads = 1) -> double;
 
 } // namespace comp6771
 #endif // COMP6771_EUCLIDEAN_VECTOR_HPP
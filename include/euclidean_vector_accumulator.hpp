@@ -0,0 +1,76 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_ACCUMULATOR_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_ACCUMULATOR_HPP
+
+// Sum of euclidean_vectors added from many threads at once, e.g. gradients from a pool of workers.
+//
+// Guarding one shared total with a mutex serialises every add. Instead each thread adds into its
+// own partial sum (its shard), with no locks and no atomics; total() adds the shards together.
+// Each shard is a separate euclidean_vector, so each has its own cache-line aligned buffer and
+// threads never write to the same cache line.
+//
+//    auto gradient = comp6771::euclidean_vector_accumulator(dimensions);
+//    // on each worker thread:
+//    gradient.add(g);               // or gradient.local().axpy(-learning_rate, g)
+//    // once the workers are done:
+//    auto const sum = gradient.total();
+
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace comp6771 {
+	class euclidean_vector_accumulator {
+	public:
+		explicit euclidean_vector_accumulator(int dimensions);
+		euclidean_vector_accumulator(euclidean_vector_accumulator const&) = delete;
+		euclidean_vector_accumulator(euclidean_vector_accumulator&&) = delete;
+
+		~euclidean_vector_accumulator() noexcept = default;
+
+		auto operator=(euclidean_vector_accumulator const&) -> euclidean_vector_accumulator& = delete;
+		auto operator=(euclidean_vector_accumulator&&) -> euclidean_vector_accumulator& = delete;
+
+		// the calling thread's partial sum, created (zeroed) on its first call. Safe to call from
+		// any number of threads at once. Each thread remembers only the accumulator it used last, so
+		// the lock is skipped while a thread keeps using the same one, and taken again when it
+		// switches between accumulators. Use it for any update, e.g. local().axpy(alpha, x); it must
+		// keep the accumulator's dimensions
+		auto local() -> euclidean_vector&;
+
+		// local() += v. Throws euclidean_vector_error on mismatched dimensions
+		auto add(euclidean_vector const&) -> void;
+
+		// The sum of every thread's partial sum, added in the order the threads first called
+		// local(). Not synchronised with add(): call it (and reset()) only while no thread is
+		// adding, e.g. after joining the workers or at a barrier
+		[[nodiscard]] auto total() const -> euclidean_vector;
+
+		// zeroes every partial sum, keeping the storage for the next round
+		auto reset() -> void;
+
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto shards() const -> std::size_t; // threads that have called local()
+
+	private:
+		struct shard {
+			std::thread::id owner;
+			euclidean_vector sum;
+		};
+
+		// registers a shard for the calling thread (or finds the one it already has)
+		auto find_or_add_shard() -> euclidean_vector&;
+
+		int dimensions_;
+		std::uint64_t id_; // unique for the life of the program, so thread-local caches never
+		                   // mistake a new accumulator for a destroyed one at the same address
+		mutable std::mutex mutex_; // guards shards_ (not the sums inside them)
+		std::vector<std::unique_ptr<shard>> shards_; // unique_ptr, so shards never move
+	};
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_ACCUMULATOR_HPP
@@ -0,0 +1,138 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_CACHE_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_CACHE_HPP
+
+// Bounded, thread-safe memo cache keyed by euclidean_vector contents.
+//
+// For pipelines that see the same vector many times (from different sources), so that expensive
+// derived results, such as unit() or a norm, are computed once per distinct vector:
+//
+//    auto units = comp6771::euclidean_vector_cache<comp6771::euclidean_vector>(10000);
+//    auto u = units.get_or_compute(ev, [](auto const& v) { return comp6771::unit(v); });
+//
+// Lookups hash the vector with content_hash() and confirm with operator==, so two different
+// vectors never share an entry even if their hashes collide. Once full, the least recently used
+// entry is evicted. A key containing NaN never equals anything, itself included, so it is always
+// a miss (and its entry just waits to be evicted).
+
+#include "euclidean_vector.hpp"
+
+#include <absl/container/flat_hash_map.h>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace comp6771 {
+	template<std::copy_constructible Value>
+	class euclidean_vector_cache {
+	public:
+		explicit euclidean_vector_cache(std::size_t const capacity)
+		: capacity_(capacity) {
+			assert(capacity > 0);
+		}
+
+		// Returns the cached value for key, or computes it with compute(key), caches and returns
+		// it. compute runs without the lock held, so a slow computation doesn't block other
+		// threads; if two threads miss on the same key at once, both compute and the first to
+		// finish is kept.
+		template<std::invocable<euclidean_vector const&> Compute>
+		requires std::convertible_to<std::invoke_result_t<Compute&, euclidean_vector const&>, Value>
+		auto get_or_compute(euclidean_vector const& key, Compute compute) -> Value {
+			auto const hash = key.content_hash();
+			if (auto cached = find(key, hash)) {
+				return *std::move(cached);
+			}
+
+			auto value = Value(std::invoke(compute, key));
+			auto const lock = std::lock_guard(mutex_);
+			++misses_; // even if someone else got there first, this call computed
+			if (auto const it = index_.find(lookup_key{&key, hash}); it != index_.end()) {
+				entries_.splice(entries_.begin(), entries_, it->second);
+				return it->second->value;
+			}
+			entries_.push_front(entry{key, hash, std::move(value)});
+			index_.emplace(lookup_key{&entries_.front().key, hash}, entries_.begin());
+			if (entries_.size() > capacity_) {
+				// found by address, which works even for a key that isn't equal to itself
+				index_.erase(lookup_key{&entries_.back().key, entries_.back().hash});
+				entries_.pop_back();
+			}
+			return entries_.front().value;
+		}
+
+		[[nodiscard]] auto size() const -> std::size_t {
+			auto const lock = std::lock_guard(mutex_);
+			return entries_.size();
+		}
+
+		[[nodiscard]] auto capacity() const noexcept -> std::size_t { return capacity_; }
+
+		[[nodiscard]] auto hits() const -> std::size_t {
+			auto const lock = std::lock_guard(mutex_);
+			return hits_;
+		}
+
+		[[nodiscard]] auto misses() const -> std::size_t {
+			auto const lock = std::lock_guard(mutex_);
+			return misses_;
+		}
+
+		auto clear() -> void {
+			auto const lock = std::lock_guard(mutex_);
+			index_.clear();
+			entries_.clear();
+		}
+
+	private:
+		struct entry {
+			euclidean_vector key;
+			std::uint64_t hash;
+			Value value;
+		};
+
+		// the index points at keys stored in entries_ (std::list never moves its elements), so
+		// each key is stored once. The hash travels with the pointer, so it is never recomputed.
+		// A stored key always matches itself by address, as its contents may not (NaN)
+		struct lookup_key {
+			euclidean_vector const* key;
+			std::uint64_t hash;
+		};
+		struct lookup_hash {
+			auto operator()(lookup_key const& k) const noexcept -> std::size_t {
+				return static_cast<std::size_t>(k.hash);
+			}
+		};
+		struct lookup_equal {
+			auto operator()(lookup_key const& lhs, lookup_key const& rhs) const -> bool {
+				return lhs.key == rhs.key or (lhs.hash == rhs.hash and *lhs.key == *rhs.key);
+			}
+		};
+
+		using entry_list = std::list<entry>;
+
+		auto find(euclidean_vector const& key, std::uint64_t const hash) -> std::optional<Value> {
+			auto const lock = std::lock_guard(mutex_);
+			auto const it = index_.find(lookup_key{&key, hash});
+			if (it == index_.end()) {
+				return std::nullopt;
+			}
+			entries_.splice(entries_.begin(), entries_, it->second); // now most recently used
+			++hits_;
+			return it->second->value;
+		}
+
+		std::size_t capacity_;
+		mutable std::mutex mutex_;
+		entry_list entries_; // most recently used first
+		absl::flat_hash_map<lookup_key, typename entry_list::iterator, lookup_hash, lookup_equal> index_;
+		std::size_t hits_ = 0;
+		std::size_t misses_ = 0;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_CACHE_HPP
@@ -0,0 +1,177 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_PIPELINE_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_PIPELINE_HPP
+
+// Streaming pipeline over euclidean_vectors, built on C++20 coroutines.
+//
+// Each stage is a generator that pulls one item at a time from the stage before it, so a chain
+// such as  write_scores(score(normalise(read_vectors(in)), query), out)  only ever holds a
+// handful of vectors in memory, no matter how big the input is. Pulling gives backpressure for
+// free: an upstream stage is only resumed when its consumer asks for the next item.
+// prefetch() adds a bounded buffer filled by a worker thread, so (for example) file reading can
+// overlap with the compute stages after it.
+
+#include "euclidean_vector.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace comp6771 {
+	// minimal single-pass generator (std::generator only arrives in C++23). Values are moved out
+	// of the coroutine, and exceptions thrown inside it are rethrown to the consumer
+	template<typename T>
+	class generator {
+	public:
+		struct promise_type {
+			std::optional<T> value_;
+			std::exception_ptr exception_;
+
+			auto get_return_object() -> generator {
+				return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+			auto final_suspend() noexcept -> std::suspend_always { return {}; }
+			auto yield_value(T value) -> std::suspend_always {
+				value_ = std::move(value);
+				return {};
+			}
+			auto return_void() noexcept -> void {}
+			auto unhandled_exception() noexcept -> void { exception_ = std::current_exception(); }
+		};
+
+		class iterator {
+		public:
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() noexcept = default;
+			explicit iterator(std::coroutine_handle<promise_type> coroutine) noexcept
+			: coroutine_(coroutine) {}
+
+			auto operator*() const -> T& { return *coroutine_.promise().value_; }
+			auto operator++() -> iterator& {
+				resume(coroutine_);
+				return *this;
+			}
+			auto operator++(int) -> void { ++*this; }
+			friend auto operator==(iterator const& it, std::default_sentinel_t) noexcept -> bool {
+				return not it.coroutine_ or it.coroutine_.done();
+			}
+
+		private:
+			std::coroutine_handle<promise_type> coroutine_ = nullptr;
+		};
+
+		explicit generator(std::coroutine_handle<promise_type> coroutine) noexcept
+		: coroutine_(coroutine) {}
+		generator(generator const&) = delete;
+		generator(generator&& other) noexcept
+		: coroutine_(std::exchange(other.coroutine_, nullptr)) {}
+		auto operator=(generator const&) -> generator& = delete;
+		auto operator=(generator&& other) noexcept -> generator& {
+			if (this != &other) {
+				destroy();
+				coroutine_ = std::exchange(other.coroutine_, nullptr);
+			}
+			return *this;
+		}
+		~generator() { destroy(); }
+
+		// starts the coroutine, running it up to its first co_yield. Single pass: call once
+		auto begin() -> iterator {
+			resume(coroutine_);
+			return iterator(coroutine_);
+		}
+		auto end() noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+	private:
+		std::coroutine_handle<promise_type> coroutine_;
+
+		static auto resume(std::coroutine_handle<promise_type> coroutine) -> void {
+			coroutine.promise().value_.reset();
+			coroutine.resume();
+			if (coroutine.promise().exception_) {
+				std::rethrow_exception(std::exchange(coroutine.promise().exception_, nullptr));
+			}
+		}
+
+		auto destroy() noexcept -> void {
+			if (coroutine_) {
+				coroutine_.destroy();
+			}
+		}
+	};
+
+	// Source: reads one vector per line, magnitudes separated by whitespace. Blank lines are
+	// skipped; a line that doesn't parse as doubles throws euclidean_vector_error
+	auto read_vectors(std::istream&) -> generator<euclidean_vector>;
+
+	// Stages
+	auto normalise(generator<euclidean_vector>) -> generator<euclidean_vector>; // applies unit()
+	auto score(generator<euclidean_vector>, euclidean_vector query) -> generator<double>; // dot()
+
+	// Sink: writes one score per line and returns how many were written
+	auto write_scores(generator<double>, std::ostream&) -> std::size_t;
+
+	// Runs upstream on a worker thread, which stays at most `capacity` items ahead of the consumer
+	// (it blocks once the buffer is full, so memory stays bounded). Dropping the returned
+	// generator early stops the worker.
+	template<typename T>
+	auto prefetch(generator<T> upstream, std::size_t const capacity) -> generator<T> {
+		assert(capacity > 0);
+		auto mutex = std::mutex();
+		auto changed = std::condition_variable_any();
+		auto buffer = std::deque<T>();
+		auto finished = false;
+		auto failure = std::exception_ptr();
+
+		// declared last, so it is destroyed (stop requested and joined) before what it uses
+		auto worker = std::jthread([&](std::stop_token const& stop) {
+			try {
+				for (auto& item : upstream) {
+					auto lock = std::unique_lock(mutex);
+					if (not changed.wait(lock, stop, [&] { return buffer.size() < capacity; })) {
+						return; // consumer went away
+					}
+					buffer.push_back(std::move(item));
+					changed.notify_all();
+				}
+			} catch (...) {
+				auto const lock = std::lock_guard(mutex);
+				failure = std::current_exception();
+			}
+			auto const lock = std::lock_guard(mutex);
+			finished = true;
+			changed.notify_all();
+		});
+
+		while (true) {
+			auto lock = std::unique_lock(mutex);
+			changed.wait(lock, [&] { return not buffer.empty() or finished; });
+			if (buffer.empty()) {
+				if (failure) {
+					std::rethrow_exception(failure);
+				}
+				co_return;
+			}
+			auto item = std::move(buffer.front());
+			buffer.pop_front();
+			changed.notify_all();
+			lock.unlock(); // don't hold the lock while the consumer works on the item
+			co_yield std::move(item);
+		}
+	}
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_PIPELINE_HPP
@@ -0,0 +1,61 @@
+#ifndef COMP6771_KMEANS_HPP
+#define COMP6771_KMEANS_HPP
+
+// k-means clustering over euclidean_vectors.
+//
+// Points are held as the rows of a euclidean_matrix, so the whole data set is one contiguous,
+// cache-line aligned allocation, and every distance is computed straight from the row storage:
+// nothing is allocated per point or per distance, unlike the usual  euclidean_norm(a - b)  loop.
+// Centroids are seeded with k-means++, then refined with Lloyd iterations (every point, every
+// iteration) or, with a batch size set, with mini-batch updates (Sculley, "Web-scale k-means
+// clustering", 2010), which trade some accuracy for iterations that don't touch the whole set.
+//
+// The assignment steps, and the centroid sums that Lloyd iterations accumulate alongside them,
+// are split between threads. Results are deterministic for a given seed and thread count, with any
+// standard library (the random numbers come straight from mt19937_64's output, not from the
+// standard distributions, which differ between libraries); other thread counts add the centroid
+// sums in a different order, so they can differ in the last bits.
+
+#include "euclidean_matrix.hpp"
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	struct kmeans_options {
+		int clusters = 8;
+		int max_iterations = 100;
+		// Lloyd iterations stop once no point changes cluster, or once no centroid moves further
+		// than this (euclidean distance). Mini-batch runs only use the centroid movement
+		double tolerance = 1e-4;
+		// 0 runs Lloyd iterations; anything else runs mini-batch iterations on this many points
+		// sampled (with replacement) each iteration
+		std::size_t batch_size = 0;
+		std::uint64_t seed = 0;
+		int threads = 1; // below 1 means every hardware thread
+	};
+
+	struct kmeans_result {
+		euclidean_matrix centroids; // one row per cluster
+		std::vector<int> assignments; // cluster of each point
+		double inertia; // sum of squared distances from each point to its centroid
+		int iterations;
+		bool converged; // stopped on the tolerance rather than on max_iterations
+	};
+
+	// Clusters the rows of `points`. Throws euclidean_vector_error unless there is at least one
+	// column and 1 <= clusters <= rows, or if max_iterations is negative. Clusters that end up
+	// empty during Lloyd iterations are reseeded with the points furthest from their centroids
+	auto kmeans(euclidean_matrix const& points, kmeans_options const& options) -> kmeans_result;
+
+	// same, for points held as separate vectors (copied into a matrix first). Also throws
+	// euclidean_vector_error if the vectors' dimensions differ
+	auto kmeans(std::span<euclidean_vector const> points, kmeans_options const& options)
+	   -> kmeans_result;
+
+} // namespace comp6771
+
+#endif // COMP6771_KMEANS_HPP
@@ -0,0 +1,87 @@
+#ifndef COMP6771_NPY_HPP
+#define COMP6771_NPY_HPP
+
+// Reading and writing NumPy .npy files, so vectors can be exchanged with Python without a text
+// round trip.
+//
+// npy_file memory-maps a file and exposes its array in place: values() and row() are views
+// straight into the mapping, so opening even a very large file costs no copying and only the
+// pages actually touched are read from disk. row_vector(), to_vectors() and to_matrix() copy into
+// euclidean_vector / euclidean_matrix storage when the library's own types are needed (those
+// guarantee aligned, zero-padded storage, which a mapping of someone else's file can't).
+//
+// Supported: little-endian float64 ('<f8') and float32 ('<f4') arrays in C order, 1-D (one
+// vector) or 2-D (one vector per row), in format versions 1.0 to 3.0. The views need float64;
+// float32 arrays are converted on copying. write_npy() writes version 1.0 files (2.0 if the
+// header needs it) that numpy.load reads directly, streaming float64 data straight from the
+// vectors' storage. POSIX only (the reader uses mmap), and little-endian hosts only.
+
+#include "euclidean_matrix.hpp"
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace comp6771 {
+	enum class npy_dtype {
+		float64,
+		float32,
+	};
+
+	class npy_file {
+	public:
+		// maps the file. Throws euclidean_vector_error if it can't be opened or mapped, isn't a
+		// .npy file, is shorter than its header says, or holds an array of an unsupported kind
+		explicit npy_file(std::string const& path);
+		npy_file(npy_file const&) = delete;
+		npy_file(npy_file&&) noexcept;
+
+		~npy_file() noexcept; // unmaps
+
+		auto operator=(npy_file const&) -> npy_file& = delete;
+		auto operator=(npy_file&&) noexcept -> npy_file&;
+
+		[[nodiscard]] auto dtype() const noexcept -> npy_dtype;
+		[[nodiscard]] auto rank() const noexcept -> int; // 1 or 2
+		// a 1-D array is one row of vectors
+		[[nodiscard]] auto rows() const noexcept -> int;
+		[[nodiscard]] auto columns() const noexcept -> int;
+
+		// Zero-copy views into the mapping, valid while this npy_file lives: every value in row
+		// order, and one row. Throw euclidean_vector_error unless dtype() is float64
+		[[nodiscard]] auto values() const -> std::span<double const>;
+		[[nodiscard]] auto row(int) const -> std::span<double const>; // asserts on a bad index
+		// the same for float32 arrays
+		[[nodiscard]] auto float_values() const -> std::span<float const>;
+
+		// copies, for either dtype
+		[[nodiscard]] auto row_vector(int) const -> euclidean_vector;
+		[[nodiscard]] auto to_vectors() const -> std::vector<euclidean_vector>;
+		[[nodiscard]] auto to_matrix() const -> euclidean_matrix;
+
+	private:
+		void* mapping_ = nullptr;
+		std::size_t mapping_size_ = 0;
+		std::byte const* data_ = nullptr; // first array value, inside the mapping
+		npy_dtype dtype_ = npy_dtype::float64;
+		int rank_ = 1;
+		std::size_t rows_ = 0;
+		std::size_t columns_ = 0;
+
+		auto unmap() noexcept -> void;
+	};
+
+	// Writers. Each writes one complete .npy file to a stream opened in binary mode, and throws
+	// euclidean_vector_error if the stream fails. float32 rounds every value to float
+	auto write_npy(std::ostream&, euclidean_vector const&, npy_dtype = npy_dtype::float64) -> void; // 1-D
+	// 2-D, one row per vector. Also throws euclidean_vector_error if the dimensions differ
+	auto write_npy(std::ostream&, std::span<euclidean_vector const>, npy_dtype = npy_dtype::float64)
+	   -> void;
+	auto write_npy(std::ostream&, euclidean_matrix const&, npy_dtype = npy_dtype::float64) -> void; // 2-D
+
+} // namespace comp6771
+
+#endif // COMP6771_NPY_HPP
@@ -0,0 +1,70 @@
+#ifndef COMP6771_QUANTISED_VECTOR_HPP
+#define COMP6771_QUANTISED_VECTOR_HPP
+
+// Compressed (int8) storage for euclidean_vectors, for corpora too large to keep as doubles.
+//
+// Each magnitude is stored as an 8-bit code q, and decodes to offset + scale * q, with one scale
+// and offset per vector chosen so the codes span [-127, 127]. That is an 8x saving over double
+// storage. Dot products and distances between quantised vectors are computed mostly in integer
+// arithmetic, which vectorises well; they are approximate, so the usual pattern is to shortlist
+// with the quantised vectors and rerank() the shortlist against the exact euclidean_vectors.
+
+#include "euclidean_vector.hpp"
+#include "top_k.hpp" // scored_index
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	class quantised_vector {
+	public:
+		explicit quantised_vector(euclidean_vector const&); // encode
+		quantised_vector(quantised_vector const&);
+		quantised_vector(quantised_vector&&) noexcept;
+
+		~quantised_vector() noexcept = default;
+
+		auto operator=(quantised_vector const&) -> quantised_vector&;
+		auto operator=(quantised_vector&&) noexcept -> quantised_vector&;
+
+		[[nodiscard]] auto decode() const -> euclidean_vector;
+
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto scale() const noexcept -> double;
+		[[nodiscard]] auto offset() const noexcept -> double;
+		[[nodiscard]] auto codes() const noexcept -> std::span<std::int8_t const>;
+
+		friend auto approximate_dot(quantised_vector const&, quantised_vector const&) -> double;
+		friend auto approximate_distance(quantised_vector const&, quantised_vector const&) -> double;
+
+	private:
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		std::unique_ptr<std::int8_t[]> codes_;
+		std::size_t dimensions_;
+		double scale_;
+		double offset_;
+
+		// sum of the codes, and squared norm of the decoded vector, worked out once at encode time
+		// since every dot product and distance needs them
+		std::int64_t code_sum_;
+		double squared_norm_;
+	};
+
+	// approximations of dot() and euclidean_norm(a - b) on the decoded vectors. Both throw
+	// euclidean_vector_error on mismatched dimensions
+	auto approximate_dot(quantised_vector const&, quantised_vector const&) -> double;
+	auto approximate_distance(quantised_vector const&, quantised_vector const&) -> double;
+
+	// Exact second stage of a quantised search: scores every candidate index (into corpus) with
+	// the exact dot() against query and returns the best k, highest score first
+	auto rerank(euclidean_vector const& query,
+	            std::span<euclidean_vector const> corpus,
+	            std::span<std::size_t const> candidates,
+	            std::size_t k) -> std::vector<scored_index>;
+
+} // namespace comp6771
+
+#endif // COMP6771_QUANTISED_VECTOR_HPP
@@ -0,0 +1,75 @@
+#ifndef COMP6771_RANDOM_PROJECTION_HPP
+#define COMP6771_RANDOM_PROJECTION_HPP
+
+// Johnson-Lindenstrauss random projection: maps euclidean_vectors to far fewer dimensions while
+// roughly preserving the distances (and dot products) between them, so search and clustering can
+// run on the short vectors instead of the long ones.
+//
+// The projection is a random output x input matrix, scaled so squared norms are preserved in
+// expectation. With output dimensions from target_dimensions(n, epsilon), every pairwise distance
+// among n points stays within a factor of 1 +- epsilon with high probability. Two kinds of matrix:
+//
+//  - gaussian: independent N(0, 1/output) entries
+//  - sparse: Achlioptas' entries, sqrt(3/output) times +1 or -1 with probability 1/6 each and 0
+//    otherwise. Two thirds of the entries are zero and the rest share one magnitude, which makes
+//    the matrix much cheaper to generate, with the same guarantee
+//
+// The matrix is generated from the seed alone, with its own conversion from std::mt19937_64 bits
+// rather than the standard distributions (whose output is up to each library). A seed gives the
+// same sparse projection with any standard library. The gaussian kind goes through std::log,
+// std::cos and std::sin, which aren't required to be correctly rounded, so with a different C
+// library its entries can differ in the last bits. Projections are euclidean_matrix products, so
+// they are blocked for cache, and batches can be split between threads.
+
+#include "euclidean_matrix.hpp"
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	enum class projection_kind {
+		gaussian,
+		sparse, // Achlioptas
+	};
+
+	class random_projection {
+	public:
+		// throws euclidean_vector_error unless both dimensions are at least 1
+		random_projection(int input_dimensions,
+		                  int output_dimensions,
+		                  projection_kind kind = projection_kind::gaussian,
+		                  std::uint64_t seed = 0);
+
+		[[nodiscard]] auto input_dimensions() const noexcept -> int;
+		[[nodiscard]] auto output_dimensions() const noexcept -> int;
+		[[nodiscard]] auto kind() const noexcept -> projection_kind;
+		[[nodiscard]] auto seed() const noexcept -> std::uint64_t;
+		[[nodiscard]] auto matrix() const noexcept -> euclidean_matrix const&; // output x input
+
+		// All of these throw euclidean_vector_error if the input doesn't have input_dimensions().
+		// `threads` splits the batch between that many threads; below 1 means every hardware thread
+		[[nodiscard]] auto operator()(euclidean_vector const&) const -> euclidean_vector;
+		// one projected row per input row
+		[[nodiscard]] auto operator()(euclidean_matrix const&, int threads = 1) const -> euclidean_matrix;
+		[[nodiscard]] auto operator()(std::span<euclidean_vector const>, int threads = 1) const
+		   -> std::vector<euclidean_vector>;
+
+	private:
+		projection_kind kind_;
+		std::uint64_t seed_;
+		euclidean_matrix matrix_;
+	};
+
+	// Output dimensions that keep every pairwise distance among `points` vectors within a factor of
+	// 1 +- epsilon with high probability: 4 ln(points) / (epsilon^2 / 2 - epsilon^3 / 3), from
+	// Dasgupta and Gupta's proof of the Johnson-Lindenstrauss lemma. Independent of the input
+	// dimensions, so only worth it when the result is well below them. Throws
+	// euclidean_vector_error unless 0 < epsilon < 1
+	auto target_dimensions(std::size_t points, double epsilon) -> int;
+
+} // namespace comp6771
+
+#endif // COMP6771_RANDOM_PROJECTION_HPP
@@ -0,0 +1,93 @@
+#ifndef COMP6771_RUNNING_STATISTICS_HPP
+#define COMP6771_RUNNING_STATISTICS_HPP
+
+// Running mean and variance (and optionally the full covariance matrix) of a stream of
+// euclidean_vectors, updated one sample or one batch at a time.
+//
+// Keeping a running sum with operator+ allocates a temporary per sample, and working the variance
+// out as E[x^2] - E[x]^2 cancels catastrophically when the spread is small next to the mean.
+// Instead this keeps Welford's running mean and sums of squared deviations from it, updated in
+// place: add() never allocates. Batches are summarised on their own (two passes: mean, then
+// deviations from it) and merged in with Chan et al.'s pairwise formula, which is also how
+// statistics gathered on different threads are combined:
+//
+//    // on each worker thread, over its share of the stream:
+//    auto local = comp6771::running_statistics(dimensions);
+//    local.add(x);
+//    // once the workers are done, in a fixed order:
+//    total.merge(local);
+//
+// The covariance is O(dimensions^2) to store and to update, so it is only tracked when asked for.
+// Only its upper triangle is updated; covariance() fills in the rest, so the result is exactly
+// symmetric, and its diagonal is exactly variance().
+
+#include "euclidean_matrix.hpp"
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace comp6771 {
+	class running_statistics {
+	public:
+		// statistics of vectors with `dimensions` dimensions, with or without covariance
+		explicit running_statistics(int dimensions, bool covariance = false);
+
+		// one sample. Throws euclidean_vector_error on mismatched dimensions; the unchecked
+		// overload only asserts
+		auto add(euclidean_vector const&) -> void;
+		auto add(euclidean_vector const&, unchecked_t) noexcept -> void;
+
+		// A batch of samples (a span of vectors, or one per matrix row), split between `threads`
+		// threads (below 1 means every hardware thread). Each thread summarises its share, and the
+		// summaries are merged in order, so the result depends on the thread count only in the last
+		// bits. Dimensions are all checked (throwing euclidean_vector_error) before anything changes
+		auto add(std::span<euclidean_vector const>, int threads = 1) -> void;
+		auto add(euclidean_matrix const&, int threads = 1) -> void;
+
+		// adds in every sample other has seen, as if they had been add()ed here. Throws
+		// euclidean_vector_error on mismatched dimensions, or if this tracks covariance and other
+		// doesn't
+		auto merge(running_statistics const& other) -> void;
+
+		// forgets every sample, keeping the storage for the next round
+		auto reset() noexcept -> void;
+
+		[[nodiscard]] auto count() const noexcept -> std::size_t;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto tracks_covariance() const noexcept -> bool;
+
+		// all zero before the first sample
+		[[nodiscard]] auto mean() const noexcept -> euclidean_vector const&;
+
+		// Population (divided by count) and sample (divided by count - 1) statistics. Throw
+		// euclidean_vector_error with fewer than 1 (or 2, for the sample forms) samples, and the
+		// covariance forms also if covariance isn't being tracked
+		[[nodiscard]] auto variance() const -> euclidean_vector;
+		[[nodiscard]] auto sample_variance() const -> euclidean_vector;
+		[[nodiscard]] auto covariance() const -> euclidean_matrix;
+		[[nodiscard]] auto sample_covariance() const -> euclidean_matrix;
+
+	private:
+		std::size_t count_ = 0;
+		bool covariance_;
+		euclidean_vector mean_;
+		euclidean_vector squared_deviations_; // Welford's M2, per dimension
+		euclidean_matrix comoments_; // upper triangle of the sums of deviation products; 0 x 0
+		                             // unless tracking covariance
+		euclidean_vector delta_; // scratch, so updates don't allocate
+
+		// adds row(0) to row(count - 1), each a span of dimensions() values
+		template<typename Row>
+		auto add_rows(std::size_t count, Row const& row, int threads) -> void;
+		// sets this (empty) summary to the statistics of row(begin) to row(end - 1)
+		template<typename Row>
+		auto summarise(std::size_t begin, std::size_t end, Row const& row) noexcept -> void;
+
+		auto check_dimensions(int dimensions) const -> void;
+		[[nodiscard]] auto scaled_variance(std::size_t minimum) const -> euclidean_vector;
+		[[nodiscard]] auto scaled_covariance(std::size_t minimum) const -> euclidean_matrix;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_RUNNING_STATISTICS_HPP
@@ -0,0 +1,283 @@
+#ifndef COMP6771_STATIC_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_STATIC_EUCLIDEAN_VECTOR_HPP
+
+// Fixed-dimension, constexpr companion to euclidean_vector, for constant tables (basis vectors,
+// lookup tables, unit vectors) worked out by the compiler instead of at startup:
+//
+//    constexpr auto up = comp6771::unit(comp6771::static_euclidean_vector<3>{0, 0, 2});
+//    constexpr auto diagonal = comp6771::euclidean_norm(comp6771::static_euclidean_vector<2>{1, 1});
+//
+// euclidean_vector itself can't be constexpr: its storage comes from aligned operator new with an
+// atomic reference count in front of it, none of which constant evaluation allows. And even a
+// constexpr-allocating vector could only allocate transiently, so it could never become a constant
+// table. The dimension here is a template parameter instead, and the magnitudes live in a
+// std::array, so a static_euclidean_vector can be a constexpr variable.
+//
+// The operations mirror euclidean_vector's. dot() and euclidean_norm() give the same results as
+// theirs (in the default fast norm mode): dot() adds left to right like dot(), and the square root
+// is correctly rounded both at compile time and at run time. unit() divides by that same fast norm,
+// whereas euclidean_vector's unit() divides by the scaled norm, whose sum of squares may be added
+// in another order, so the two unit vectors can differ in the last bit.
+// Convert with the explicit euclidean_vector conversion to use one with the rest of the library.
+
+#include "euclidean_vector.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace comp6771 {
+	namespace detail {
+		// Correctly rounded square root that can run in constant evaluation (std::sqrt can't until
+		// C++26), so it gives exactly what std::sqrt gives at run time. Works on the bits: with
+		// x = m * 2^e (e even), it takes the integer square root of m * 2^56 one bit at a time,
+		// which yields the 53 result bits plus two for rounding to nearest even.
+		constexpr auto constexpr_sqrt(double const x) noexcept -> double {
+			if (x != x or x == 0.0 or x == std::numeric_limits<double>::infinity()) {
+				return x; // nan, +-0 and inf are their own square roots
+			}
+			if (x < 0.0) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+
+			constexpr auto mantissa_bits = 52;
+			constexpr auto exponent_bias = 1023;
+			constexpr auto implicit_bit = std::uint64_t{1} << mantissa_bits;
+			auto const bits = std::bit_cast<std::uint64_t>(x);
+			auto const biased_exponent = static_cast<int>(bits >> mantissa_bits);
+			auto mantissa = bits & (implicit_bit - 1);
+			auto exponent = 0;
+			if (biased_exponent == 0) { // subnormal: normalise so the implicit bit is set
+				exponent = 1 - exponent_bias - mantissa_bits;
+				while ((mantissa & implicit_bit) == 0) {
+					mantissa <<= 1;
+					--exponent;
+				}
+			}
+			else {
+				mantissa |= implicit_bit;
+				exponent = biased_exponent - exponent_bias - mantissa_bits;
+			}
+			if (exponent % 2 != 0) {
+				mantissa <<= 1;
+				--exponent;
+			}
+
+			// mantissa * 2^56 is in [2^108, 2^110), so its square root has exactly 55 bits. The
+			// radicand is consumed two bits at a time from the top; the remainder stays below
+			// 2 * root + 1 < 2^56, so it fits in 64 bits
+			constexpr auto radicand_shift = 56;
+			constexpr auto root_bits = 55;
+			auto root = std::uint64_t{0};
+			auto remainder = std::uint64_t{0};
+			for (auto i = 0; i < root_bits; ++i) {
+				auto const shift = 2 * (root_bits - 1 - i);
+				auto const next_bits = shift >= radicand_shift ? (mantissa >> (shift - radicand_shift)) & 3 : 0;
+				remainder = (remainder << 2) | next_bits;
+				auto const trial = (root << 2) | 1;
+				root <<= 1;
+				if (remainder >= trial) {
+					remainder -= trial;
+					root |= 1;
+				}
+			}
+
+			// drop the two extra bits, rounding to nearest, ties to even
+			auto const guard = (root >> 1) & 1;
+			auto const sticky = (root & 1) != 0 or remainder != 0;
+			root >>= 2;
+			if (guard != 0 and (sticky or (root & 1) != 0)) {
+				++root; // may carry into 2^53, which the addition below turns into the next exponent
+			}
+			auto const result_exponent = (exponent - radicand_shift) / 2 + 2 + mantissa_bits;
+			return std::bit_cast<double>(
+			   (static_cast<std::uint64_t>(result_exponent + exponent_bias) << mantissa_bits)
+			   + (root - implicit_bit));
+		}
+
+		constexpr auto sqrt(double const x) noexcept -> double {
+			if (std::is_constant_evaluated()) {
+				return constexpr_sqrt(x);
+			}
+			return std::sqrt(x);
+		}
+	} // namespace detail
+
+	template<std::size_t N>
+	class static_euclidean_vector {
+	public:
+		// same int convention as euclidean_vector for dimensions() and indexes
+		static_assert(N <= static_cast<std::size_t>(std::numeric_limits<int>::max()));
+
+		// constructors
+		constexpr static_euclidean_vector() noexcept = default; // all zero
+		constexpr explicit static_euclidean_vector(double const magnitude) noexcept {
+			magnitudes_.fill(magnitude);
+		}
+		// throws euclidean_vector_error unless there are exactly N values (a compile error when
+		// constant evaluated)
+		constexpr static_euclidean_vector(std::initializer_list<double> const values) {
+			if (values.size() != N) {
+				throw euclidean_vector_error("Expected " + std::to_string(N) + " magnitudes but got "
+				                             + std::to_string(values.size()));
+			}
+			auto i = std::size_t{0};
+			for (auto const value : values) {
+				magnitudes_[i++] = value;
+			}
+		}
+
+		constexpr auto operator[](int const index) const -> double {
+			assert(index >= 0 and index < dimensions());
+			return magnitudes_[static_cast<std::size_t>(index)];
+		}
+		constexpr auto operator[](int const index) -> double& {
+			assert(index >= 0 and index < dimensions());
+			return magnitudes_[static_cast<std::size_t>(index)];
+		}
+
+		[[nodiscard]] constexpr auto at(int const index) const -> double {
+			check_index(index);
+			return magnitudes_[static_cast<std::size_t>(index)];
+		}
+		constexpr auto at(int const index) -> double& {
+			check_index(index);
+			return magnitudes_[static_cast<std::size_t>(index)];
+		}
+
+		[[nodiscard]] constexpr auto dimensions() const noexcept -> int { return static_cast<int>(N); }
+
+		constexpr auto operator+() const noexcept -> static_euclidean_vector { return *this; }
+		constexpr auto operator-() const noexcept -> static_euclidean_vector {
+			auto result = *this;
+			for (auto& magnitude : result.magnitudes_) {
+				magnitude = -magnitude;
+			}
+			return result;
+		}
+
+		// no dimension checks needed: mismatched dimensions are different types
+		constexpr auto operator+=(static_euclidean_vector const& rhs) noexcept -> static_euclidean_vector& {
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				magnitudes_[i] += rhs.magnitudes_[i];
+			}
+			return *this;
+		}
+		constexpr auto operator-=(static_euclidean_vector const& rhs) noexcept -> static_euclidean_vector& {
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				magnitudes_[i] -= rhs.magnitudes_[i];
+			}
+			return *this;
+		}
+		constexpr auto operator*=(double const scalar) noexcept -> static_euclidean_vector& {
+			for (auto& magnitude : magnitudes_) {
+				magnitude *= scalar;
+			}
+			return *this;
+		}
+		constexpr auto operator/=(double const scalar) -> static_euclidean_vector& {
+			if (scalar == 0) {
+				throw euclidean_vector_error("Invalid vector division by 0");
+			}
+			for (auto& magnitude : magnitudes_) {
+				magnitude /= scalar;
+			}
+			return *this;
+		}
+
+		explicit operator euclidean_vector() const { return euclidean_vector(magnitudes_); }
+
+		friend constexpr auto operator==(static_euclidean_vector const&, static_euclidean_vector const&)
+		   -> bool = default;
+
+		friend constexpr auto operator+(static_euclidean_vector lhs, static_euclidean_vector const& rhs) noexcept
+		   -> static_euclidean_vector {
+			return lhs += rhs;
+		}
+		friend constexpr auto operator-(static_euclidean_vector lhs, static_euclidean_vector const& rhs) noexcept
+		   -> static_euclidean_vector {
+			return lhs -= rhs;
+		}
+		friend constexpr auto operator*(static_euclidean_vector v, double const scalar) noexcept
+		   -> static_euclidean_vector {
+			return v *= scalar;
+		}
+		friend constexpr auto operator*(double const scalar, static_euclidean_vector v) noexcept
+		   -> static_euclidean_vector {
+			return v *= scalar;
+		}
+		friend constexpr auto operator/(static_euclidean_vector v, double const scalar)
+		   -> static_euclidean_vector {
+			return v /= scalar;
+		}
+
+		// same format as euclidean_vector: [1 2 3]
+		friend auto operator<<(std::ostream& os, static_euclidean_vector const& v) -> std::ostream& {
+			os << '[';
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				os << (i == 0 ? "" : " ") << v.magnitudes_[i];
+			}
+			return os << ']';
+		}
+
+	private:
+		constexpr auto check_index(int const index) const -> void {
+			if (index < 0 or index >= dimensions()) {
+				throw euclidean_vector_error("Index " + std::to_string(index)
+				                             + " is not valid for this euclidean_vector object");
+			}
+		}
+
+		std::array<double, N> magnitudes_{};
+	};
+
+	// the i-th standard basis vector: 1 in dimension i, 0 elsewhere
+	template<std::size_t N>
+	constexpr auto basis(int const i) -> static_euclidean_vector<N> {
+		auto result = static_euclidean_vector<N>();
+		result.at(i) = 1.0;
+		return result;
+	}
+
+	template<std::size_t N>
+	constexpr auto dot(static_euclidean_vector<N> const& lhs, static_euclidean_vector<N> const& rhs) noexcept
+	   -> double {
+		auto result = 0.0;
+		for (auto i = 0; i < lhs.dimensions(); ++i) {
+			result += lhs[i] * rhs[i];
+		}
+		return result;
+	}
+
+	template<std::size_t N>
+	constexpr auto euclidean_norm(static_euclidean_vector<N> const& v) -> double {
+		if (v.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a norm");
+		}
+		return detail::sqrt(dot(v, v));
+	}
+
+	// v / euclidean_norm(v): see the header comment on how that compares with unit(euclidean_vector)
+	template<std::size_t N>
+	constexpr auto unit(static_euclidean_vector<N> const& v) -> static_euclidean_vector<N> {
+		if (v.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit "
+			                             "vector");
+		}
+		auto const norm = euclidean_norm(v);
+		if (norm == 0) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a "
+			                             "unit vector");
+		}
+		return v / norm;
+	}
+} // namespace comp6771
+
+#endif // COMP6771_STATIC_EUCLIDEAN_VECTOR_HPP
@@ -0,0 +1,50 @@
+#ifndef COMP6771_TOP_K_HPP
+#define COMP6771_TOP_K_HPP
+
+// Top-k selection over collections of euclidean_vectors: the k largest norms, or the k best dot
+// scores against a query, without materialising and sorting a score for every vector.
+//
+// Scoring and selection are fused: each thread scores its share of the collection and keeps only
+// its k best so far in a bounded heap, and the per-thread heaps are merged at the end. Memory is
+// proportional to k (times the thread count), not to the collection size, and each vector is
+// only touched once, while the scoring is still streaming through the cache.
+//
+// Results come highest score first; equal scores come in index order, so the result doesn't
+// depend on the thread count. Vectors scoring NaN are never selected. Scores use the same kernel
+// as dot(a, b, unchecked), so a norm score can differ from euclidean_norm() in the last bit.
+// `threads` splits the collection between that many threads; below 1 means every hardware thread.
+
+#include "euclidean_matrix.hpp"
+#include "euclidean_vector.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	struct scored_index {
+		std::size_t index;
+		double score;
+	};
+
+	// the k vectors (or matrix rows) with the largest euclidean norms
+	auto top_k_by_norm(std::span<euclidean_vector const> vectors, std::size_t k, int threads = 1)
+	   -> std::vector<scored_index>;
+	auto top_k_by_norm(euclidean_matrix const& rows, std::size_t k, int threads = 1)
+	   -> std::vector<scored_index>;
+
+	// the k vectors (or matrix rows) with the largest dot products with query. Throws
+	// euclidean_vector_error if any vector's dimensions differ from query's (checked up front)
+	auto top_k_by_dot(euclidean_vector const& query,
+	                  std::span<euclidean_vector const> vectors,
+	                  std::size_t k,
+	                  int threads = 1) -> std::vector<scored_index>;
+	auto top_k_by_dot(euclidean_vector const& query, euclidean_matrix const& rows, std::size_t k, int threads = 1)
+	   -> std::vector<scored_index>;
+
+	// the k largest of scores that have already been computed
+	auto top_k(std::span<double const> scores, std::size_t k, int threads = 1) -> std::vector<scored_index>;
+
+} // namespace comp6771
+
+#endif // COMP6771_TOP_K_HPP
@@ -0,0 +1,98 @@
+#ifndef COMP6771_DOT_KERNEL_HPP
+#define COMP6771_DOT_KERNEL_HPP
+
+// Internal dot-product kernel shared by the sources in this directory.
+//
+// A plain running sum can't be vectorised without letting the compiler reorder the additions
+// (-ffast-math). Instead each row keeps dot_lanes independent partial sums, element i going to
+// lane i % dot_lanes. The lanes fit in one SIMD register, so the compiler vectorises the loop
+// without changing what gets added to what, and the lanes are combined in a fixed order at the
+// end. The result therefore doesn't depend on the instruction set the code was built for
+// (provided the compiler doesn't fuse the multiplies and adds, hence -ffp-contract=off on the
+// targets built from this directory).
+
+#include "euclidean_vector.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace comp6771::detail {
+	inline constexpr auto dot_lanes = std::size_t{4};
+	static_assert(dot_lanes == 4, "lane combination in multi_dot is written out for four lanes");
+
+	// for spans into aligned storage (detail::make_aligned_array) that start on a cache line: lets
+	// the compiler use aligned loads
+	inline auto assume_aligned(std::span<double const> const s) noexcept -> std::span<double const> {
+		return std::span<double const>(std::assume_aligned<storage_alignment>(s.data()), s.size());
+	}
+
+	// dot products of several equal-length rows with the same x, in a single pass over x (so x is
+	// loaded once for all the rows rather than once per row). Padded storage is a whole number of
+	// lanes long, so for padded spans the tail loop never runs
+	template<std::size_t Rows>
+	auto multi_dot(std::array<std::span<double const>, Rows> const& rows,
+	               std::span<double const> const x) noexcept -> std::array<double, Rows> {
+		auto lanes = std::array<std::array<double, dot_lanes>, Rows>{};
+		auto const full = x.size() - x.size() % dot_lanes;
+		for (auto i = std::size_t{0}; i < full; i += dot_lanes) {
+			for (auto r = std::size_t{0}; r < Rows; ++r) {
+				for (auto lane = std::size_t{0}; lane < dot_lanes; ++lane) {
+					lanes[r][lane] += rows[r][i + lane] * x[i + lane];
+				}
+			}
+		}
+
+		auto result = std::array<double, Rows>{};
+		for (auto r = std::size_t{0}; r < Rows; ++r) {
+			result[r] = (lanes[r][0] + lanes[r][1]) + (lanes[r][2] + lanes[r][3]);
+			for (auto i = full; i < x.size(); ++i) {
+				result[r] += rows[r][i] * x[i];
+			}
+		}
+		return result;
+	}
+
+	inline auto dot(std::span<double const> const a, std::span<double const> const b) noexcept
+	   -> double {
+		return multi_dot<1>({a}, b)[0];
+	}
+
+	// plain sum, with the same fixed lane layout and combination order as multi_dot
+	inline auto lane_sum(std::span<double const> const x) noexcept -> double {
+		auto lanes = std::array<double, dot_lanes>{};
+		auto const full = x.size() - x.size() % dot_lanes;
+		for (auto i = std::size_t{0}; i < full; i += dot_lanes) {
+			for (auto lane = std::size_t{0}; lane < dot_lanes; ++lane) {
+				lanes[lane] += x[i + lane];
+			}
+		}
+		auto result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		for (auto i = full; i < x.size(); ++i) {
+			result += x[i];
+		}
+		return result;
+	}
+
+	// squared euclidean distance, without forming a - b: same lanes and combination order again
+	inline auto squared_distance(std::span<double const> const a, std::span<double const> const b) noexcept
+	   -> double {
+		auto lanes = std::array<double, dot_lanes>{};
+		auto const full = a.size() - a.size() % dot_lanes;
+		for (auto i = std::size_t{0}; i < full; i += dot_lanes) {
+			for (auto lane = std::size_t{0}; lane < dot_lanes; ++lane) {
+				auto const difference = a[i + lane] - b[i + lane];
+				lanes[lane] += difference * difference;
+			}
+		}
+		auto result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		for (auto i = full; i < a.size(); ++i) {
+			auto const difference = a[i] - b[i];
+			result += difference * difference;
+		}
+		return result;
+	}
+} // namespace comp6771::detail
+
+#endif // COMP6771_DOT_KERNEL_HPP
@@ -0,0 +1,487 @@
+// Dense row-major matrix and its products with euclidean_vector.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "euclidean_matrix.hpp"
+
+#include "dot_kernel.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <gsl/gsl-lite.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+
+	namespace {
+		// GEMV works through the input vector in slices of this many doubles (16 KiB, comfortably
+		// inside L1), and runs every row over one slice before moving to the next
+		constexpr auto gemv_column_block = std::size_t{2048};
+		// rows handled together per pass over a slice, so each load of x feeds several rows
+		constexpr auto gemv_row_group = std::size_t{4};
+
+		// GEMM blocking: a block of B's rows (gemm_inner_block x gemm_column_block doubles,
+		// 512 KiB) is kept in L2 while every row of A in the chunk uses it
+		constexpr auto gemm_inner_block = std::size_t{128};
+		constexpr auto gemm_column_block = std::size_t{512};
+
+		// a * transpose(b): rows of b are taken in tiles, so a tile stays in cache while every row
+		// of a in the chunk is dotted with it
+		constexpr auto gram_tile = std::size_t{64};
+
+		auto dimension_mismatch(std::string const& what, std::size_t lhs, std::size_t rhs)
+		   -> euclidean_vector_error {
+			return euclidean_vector_error("Dimensions of " + what + " (" + std::to_string(lhs)
+			                              + " and " + std::to_string(rhs) + ") do not match");
+		}
+
+		// The tiled a * transpose(b) kernel behind multiply_transposed, gram and the pairwise
+		// distances. a_row(i) and b_row(j) give padded rows (a and b have the same number of
+		// columns, so their padded rows line up), and out_row(i) the b_rows-long row of the result.
+		// finish(i, tile, segment) is called on each finished segment of an output row, while it is
+		// still in cache
+		template<typename ARow, typename BRow, typename OutRow, typename Finish>
+		auto tiled_gram(std::size_t const a_rows,
+		                std::size_t const b_rows,
+		                ARow const& a_row,
+		                BRow const& b_row,
+		                OutRow const& out_row,
+		                Finish const& finish,
+		                int const threads) -> void {
+			detail::parallel_for(
+			   a_rows,
+			   detail::thread_count(threads),
+			   [&](std::size_t, std::size_t const row_begin, std::size_t const row_end) {
+				   for (auto tile = std::size_t{0}; tile < b_rows; tile += gram_tile) {
+					   auto const tile_end = std::min(tile + gram_tile, b_rows);
+					   for (auto i = row_begin; i < row_end; ++i) {
+						   auto const a_i = detail::assume_aligned(a_row(i));
+						   auto const c_row = out_row(i);
+						   auto j = tile;
+						   // four rows of b against the same row of a, sharing its loads
+						   for (; j + 4 <= tile_end; j += 4) {
+							   auto const sums = detail::multi_dot<4>(
+							      {detail::assume_aligned(b_row(j)),
+							       detail::assume_aligned(b_row(j + 1)),
+							       detail::assume_aligned(b_row(j + 2)),
+							       detail::assume_aligned(b_row(j + 3))},
+							      a_i);
+							   ranges::copy(sums, c_row.begin() + gsl_lite::narrow_cast<std::ptrdiff_t>(j));
+						   }
+						   for (; j < tile_end; ++j) {
+							   c_row[j] = detail::dot(detail::assume_aligned(b_row(j)), a_i);
+						   }
+						   finish(i, tile, c_row.subspan(tile, tile_end - tile));
+					   }
+				   }
+			   });
+		}
+
+		auto check_gram_buffer(std::size_t const a_rows, std::size_t const b_rows, std::span<double> const out)
+		   -> void {
+			if (out.size() != a_rows * b_rows) {
+				throw dimension_mismatch("output buffer and result", out.size(), a_rows * b_rows);
+			}
+		}
+
+		// squared norm of each row, with the same kernel as the dot products they are combined with
+		template<typename Row>
+		auto squared_norms(std::size_t const rows, Row const& row, int const threads) -> std::vector<double> {
+			auto norms = std::vector<double>(rows);
+			detail::parallel_for(rows,
+			                     detail::thread_count(threads),
+			                     [&](std::size_t, std::size_t const begin, std::size_t const end) {
+				                     for (auto i = begin; i < end; ++i) {
+					                     auto const r = detail::assume_aligned(row(i));
+					                     norms[i] = detail::dot(r, r);
+				                     }
+			                     });
+			return norms;
+		}
+
+		// ||a||^2 + ||b||^2 - 2 a.b from the tiled Gram kernel, turned into distances a segment at a
+		// time. Rounding can take the sum slightly below zero for (nearly) equal rows, so it is
+		// clamped, and when a and b are the same matrix the diagonal is set to exactly zero
+		template<typename ARow, typename BRow>
+		auto tiled_distances(std::size_t const a_rows,
+		                     std::size_t const b_rows,
+		                     ARow const& a_row,
+		                     BRow const& b_row,
+		                     bool const same,
+		                     std::span<double> const out,
+		                     bool const squared,
+		                     int const threads) -> void {
+			check_gram_buffer(a_rows, b_rows, out);
+			auto const a_norms = squared_norms(a_rows, a_row, threads);
+			auto const b_norms = same ? a_norms : squared_norms(b_rows, b_row, threads);
+			tiled_gram(
+			   a_rows,
+			   b_rows,
+			   a_row,
+			   b_row,
+			   [&](std::size_t const i) { return out.subspan(i * b_rows, b_rows); },
+			   [&](std::size_t const i, std::size_t const tile, std::span<double> const segment) {
+				   auto j = tile;
+				   for (auto& value : segment) {
+					   auto const distance = std::max(0.0, a_norms[i] + b_norms[j] - 2.0 * value);
+					   value = (same and i == j) ? 0.0 : (squared ? distance : std::sqrt(distance));
+					   ++j;
+				   }
+			   },
+			   threads);
+		}
+	} // namespace
+
+	// constructors
+
+	euclidean_matrix::euclidean_matrix(int const rows, int const columns, double const value) {
+		assert(rows >= 0 and columns >= 0);
+		rows_ = gsl_lite::narrow_cast<std::size_t>(rows);
+		columns_ = gsl_lite::narrow_cast<std::size_t>(columns);
+		stride_ = detail::padded_size(columns_); // so every row starts on a cache line
+		values_ = detail::make_aligned_array(rows_ * stride_);
+		// zero everything first, as the padding at the end of each row must be zero
+		ranges::fill(std::span<double>(values_.get(), rows_ * stride_), 0.0);
+		if (value != 0.0) {
+			for (auto r = std::size_t{0}; r < rows_; ++r) {
+				ranges::fill(padded_row(r).first(columns_), value);
+			}
+		}
+	}
+
+	euclidean_matrix::euclidean_matrix(int const rows, int const columns)
+	: euclidean_matrix(rows, columns, 0.0) {}
+
+	euclidean_matrix::euclidean_matrix(int const rows,
+	                                   int const columns,
+	                                   std::initializer_list<double> const values)
+	: euclidean_matrix(rows, columns) {
+		if (values.size() != rows_ * columns_) {
+			throw dimension_mismatch("matrix and initialiser list", rows_ * columns_, values.size());
+		}
+		for (auto r = std::size_t{0}; r < rows_; ++r) {
+			ranges::copy(values.begin() + gsl_lite::narrow_cast<std::ptrdiff_t>(r * columns_),
+			             values.begin() + gsl_lite::narrow_cast<std::ptrdiff_t>((r + 1) * columns_),
+			             padded_row(r).begin());
+		}
+	}
+
+	euclidean_matrix::euclidean_matrix(std::span<euclidean_vector const> const vectors)
+	: euclidean_matrix(gsl_lite::narrow_cast<int>(vectors.size()),
+	                   vectors.empty() ? 0 : vectors.front().dimensions()) {
+		for (auto r = std::size_t{0}; r < rows_; ++r) {
+			auto const& ev = vectors[r];
+			if (ev.dimensions_ != columns_) {
+				throw dimension_mismatch("matrix row and euclidean_vector", columns_, ev.dimensions_);
+			}
+			ranges::copy(std::span<double const>(ev.magnitudes_.get(), ev.dimensions_),
+			             row(gsl_lite::narrow_cast<int>(r)).begin());
+		}
+	}
+
+	euclidean_matrix::euclidean_matrix(euclidean_matrix const& other)
+	: euclidean_matrix(other.rows(), other.columns()) {
+		// padding included, it is zero in both
+		ranges::copy(std::span<double const>(other.values_.get(), rows_ * stride_), values_.get());
+	}
+
+	euclidean_matrix::euclidean_matrix(euclidean_matrix&& other) noexcept
+	: values_(std::move(other.values_))
+	, rows_(std::exchange(other.rows_, 0))
+	, columns_(std::exchange(other.columns_, 0))
+	, stride_(std::exchange(other.stride_, 0)) {}
+
+	auto euclidean_matrix::operator=(euclidean_matrix const& other) -> euclidean_matrix& {
+		if (this != &other) {
+			*this = euclidean_matrix(other); // copy, then take it over with the move assignment
+		}
+		return *this;
+	}
+
+	auto euclidean_matrix::operator=(euclidean_matrix&& other) noexcept -> euclidean_matrix& {
+		values_ = std::move(other.values_);
+		rows_ = std::exchange(other.rows_, 0);
+		columns_ = std::exchange(other.columns_, 0);
+		stride_ = std::exchange(other.stride_, 0);
+		return *this;
+	}
+
+	// element and row access
+
+	auto euclidean_matrix::operator()(int const row, int const column) const -> double {
+		assert(row >= 0 and gsl_lite::narrow_cast<std::size_t>(row) < rows_);
+		assert(column >= 0 and gsl_lite::narrow_cast<std::size_t>(column) < columns_);
+		return values_[gsl_lite::narrow_cast<std::size_t>(row) * stride_
+		               + gsl_lite::narrow_cast<std::size_t>(column)];
+	}
+
+	auto euclidean_matrix::operator()(int const row, int const column) -> double& {
+		assert(row >= 0 and gsl_lite::narrow_cast<std::size_t>(row) < rows_);
+		assert(column >= 0 and gsl_lite::narrow_cast<std::size_t>(column) < columns_);
+		return values_[gsl_lite::narrow_cast<std::size_t>(row) * stride_
+		               + gsl_lite::narrow_cast<std::size_t>(column)];
+	}
+
+	auto euclidean_matrix::rows() const noexcept -> int {
+		return gsl_lite::narrow_cast<int>(rows_);
+	}
+
+	auto euclidean_matrix::columns() const noexcept -> int {
+		return gsl_lite::narrow_cast<int>(columns_);
+	}
+
+	auto euclidean_matrix::row(int const row) const -> std::span<double const> {
+		assert(row >= 0 and gsl_lite::narrow_cast<std::size_t>(row) < rows_);
+		return padded_row(gsl_lite::narrow_cast<std::size_t>(row)).first(columns_);
+	}
+
+	auto euclidean_matrix::row(int const row) -> std::span<double> {
+		assert(row >= 0 and gsl_lite::narrow_cast<std::size_t>(row) < rows_);
+		return padded_row(gsl_lite::narrow_cast<std::size_t>(row)).first(columns_);
+	}
+
+	auto euclidean_matrix::padded_row(std::size_t const row) const noexcept
+	   -> std::span<double const> {
+		return std::span<double const>(values_.get(), rows_ * stride_).subspan(row * stride_, stride_);
+	}
+
+	auto euclidean_matrix::padded_row(std::size_t const row) noexcept -> std::span<double> {
+		return std::span<double>(values_.get(), rows_ * stride_).subspan(row * stride_, stride_);
+	}
+
+	auto euclidean_matrix::row_vector(int const row_index) const -> euclidean_vector {
+		return euclidean_vector(row(row_index));
+	}
+
+	// friends
+
+	auto operator==(euclidean_matrix const& lhs, euclidean_matrix const& rhs) -> bool {
+		if (lhs.rows_ != rhs.rows_ or lhs.columns_ != rhs.columns_) {
+			return false;
+		}
+		// padding is always zero, so whole padded buffers can be compared in one go
+		auto const size = lhs.rows_ * lhs.stride_;
+		return ranges::equal(std::span<double const>(lhs.values_.get(), size),
+		                     std::span<double const>(rhs.values_.get(), size));
+	}
+
+	// one row per line, each formatted like a euclidean_vector: [1 2]\n[3 4]\n
+	auto operator<<(std::ostream& os, euclidean_matrix const& m) -> std::ostream& {
+		for (auto r = 0; r < m.rows(); ++r) {
+			os << m.row_vector(r) << '\n';
+		}
+		return os;
+	}
+
+	// products
+
+	auto multiply(euclidean_matrix const& m, euclidean_vector const& x, int const threads)
+	   -> euclidean_vector {
+		if (gsl_lite::narrow_cast<std::size_t>(m.columns()) != x.dimensions_) {
+			throw dimension_mismatch("matrix columns and euclidean_vector",
+			                         gsl_lite::narrow_cast<std::size_t>(m.columns()),
+			                         x.dimensions_);
+		}
+
+		auto result = euclidean_vector(m.rows());
+		// x and the rows of m are both zero-padded to m.stride_, so the kernel runs over the padded
+		// length: every block is then a whole number of lanes and starts on a cache line
+		auto const x_span = std::span<double const>(x.magnitudes_.get(), m.stride_);
+		auto const y_span = std::span<double>(result.magnitudes_.get(), result.dimensions_);
+		auto const columns = m.stride_;
+
+		// each thread owns a contiguous range of output rows, so no two threads write the same y
+		detail::parallel_for(
+		   y_span.size(),
+		   detail::thread_count(threads),
+		   [&](std::size_t, std::size_t const row_begin, std::size_t const row_end) {
+			   for (auto block = std::size_t{0}; block < columns; block += gemv_column_block) {
+				   auto const width = std::min(gemv_column_block, columns - block);
+				   auto const x_block = detail::assume_aligned(x_span.subspan(block, width));
+				   auto const row_block = [&](std::size_t const r) {
+					   return detail::assume_aligned(m.padded_row(r).subspan(block, width));
+				   };
+
+				   auto r = row_begin;
+				   for (; r + gemv_row_group <= row_end; r += gemv_row_group) {
+					   auto const sums = detail::multi_dot<gemv_row_group>(
+					      {row_block(r), row_block(r + 1), row_block(r + 2), row_block(r + 3)},
+					      x_block);
+					   for (auto i = std::size_t{0}; i < gemv_row_group; ++i) {
+						   y_span[r + i] += sums[i];
+					   }
+				   }
+				   for (; r < row_end; ++r) {
+					   y_span[r] += detail::dot(row_block(r), x_block);
+				   }
+			   }
+		   });
+		return result;
+	}
+
+	auto operator*(euclidean_matrix const& m, euclidean_vector const& x) -> euclidean_vector {
+		return multiply(m, x, 1);
+	}
+
+	auto multiply(euclidean_matrix const& a, euclidean_matrix const& b, int const threads)
+	   -> euclidean_matrix {
+		if (a.columns() != b.rows()) {
+			throw dimension_mismatch("LHS columns and RHS rows",
+			                         gsl_lite::narrow_cast<std::size_t>(a.columns()),
+			                         gsl_lite::narrow_cast<std::size_t>(b.rows()));
+		}
+
+		auto result = euclidean_matrix(a.rows(), b.columns());
+		auto const inner = a.columns_;
+		auto const columns = b.stride_; // padding included: zero in b, so it stays zero in c
+
+		// c_row += a(i, k) * b_row(k) for every k: the innermost loop runs along contiguous rows of
+		// b and c with no reduction, so it vectorises as is
+		detail::parallel_for(
+		   gsl_lite::narrow_cast<std::size_t>(a.rows()),
+		   detail::thread_count(threads),
+		   [&](std::size_t, std::size_t const row_begin, std::size_t const row_end) {
+			   for (auto column_block = std::size_t{0}; column_block < columns;
+			        column_block += gemm_column_block) {
+				   auto const width = std::min(gemm_column_block, columns - column_block);
+				   for (auto inner_block = std::size_t{0}; inner_block < inner;
+				        inner_block += gemm_inner_block) {
+					   auto const depth = std::min(gemm_inner_block, inner - inner_block);
+					   for (auto i = row_begin; i < row_end; ++i) {
+						   auto const a_row = a.padded_row(i);
+						   auto const c_row = result.padded_row(i).subspan(column_block, width);
+						   for (auto k = inner_block; k < inner_block + depth; ++k) {
+							   auto const a_ik = a_row[k];
+							   auto const b_row = b.padded_row(k).subspan(column_block, width);
+							   ranges::transform(c_row, b_row, c_row.begin(), [a_ik](double c, double b_kj) {
+								   return c + a_ik * b_kj;
+							   });
+						   }
+					   }
+				   }
+			   }
+		   });
+		return result;
+	}
+
+	auto operator*(euclidean_matrix const& a, euclidean_matrix const& b) -> euclidean_matrix {
+		return multiply(a, b, 1);
+	}
+
+	auto multiply_transposed(euclidean_matrix const& a, euclidean_matrix const& b, int const threads)
+	   -> euclidean_matrix {
+		if (a.columns() != b.columns()) {
+			throw dimension_mismatch("LHS and RHS columns",
+			                         gsl_lite::narrow_cast<std::size_t>(a.columns()),
+			                         gsl_lite::narrow_cast<std::size_t>(b.columns()));
+		}
+
+		auto result = euclidean_matrix(a.rows(), b.rows());
+		tiled_gram(
+		   a.rows_,
+		   b.rows_,
+		   [&](std::size_t const i) { return a.padded_row(i); },
+		   [&](std::size_t const j) { return b.padded_row(j); },
+		   [&](std::size_t const i) { return result.padded_row(i); },
+		   [](std::size_t, std::size_t, std::span<double>) {},
+		   threads);
+		return result;
+	}
+
+	auto gram(euclidean_matrix const& a,
+	          euclidean_matrix const& b,
+	          std::span<double> const out,
+	          int const threads) -> void {
+		if (a.columns() != b.columns()) {
+			throw dimension_mismatch("LHS and RHS columns",
+			                         gsl_lite::narrow_cast<std::size_t>(a.columns()),
+			                         gsl_lite::narrow_cast<std::size_t>(b.columns()));
+		}
+		check_gram_buffer(a.rows_, b.rows_, out);
+		tiled_gram(
+		   a.rows_,
+		   b.rows_,
+		   [&](std::size_t const i) { return a.padded_row(i); },
+		   [&](std::size_t const j) { return b.padded_row(j); },
+		   [&, b_rows = b.rows_](std::size_t const i) { return out.subspan(i * b_rows, b_rows); },
+		   [](std::size_t, std::size_t, std::span<double>) {},
+		   threads);
+	}
+
+	auto pairwise_distances(euclidean_matrix const& a,
+	                        euclidean_matrix const& b,
+	                        std::span<double> const out,
+	                        int const threads) -> void {
+		if (a.columns() != b.columns()) {
+			throw dimension_mismatch("LHS and RHS columns",
+			                         gsl_lite::narrow_cast<std::size_t>(a.columns()),
+			                         gsl_lite::narrow_cast<std::size_t>(b.columns()));
+		}
+		tiled_distances(
+		   a.rows_,
+		   b.rows_,
+		   [&](std::size_t const i) { return a.padded_row(i); },
+		   [&](std::size_t const j) { return b.padded_row(j); },
+		   &a == &b,
+		   out,
+		   false,
+		   threads);
+	}
+
+	auto pairwise_squared_distances(euclidean_matrix const& a,
+	                                euclidean_matrix const& b,
+	                                std::span<double> const out,
+	                                int const threads) -> void {
+		if (a.columns() != b.columns()) {
+			throw dimension_mismatch("LHS and RHS columns",
+			                         gsl_lite::narrow_cast<std::size_t>(a.columns()),
+			                         gsl_lite::narrow_cast<std::size_t>(b.columns()));
+		}
+		tiled_distances(
+		   a.rows_,
+		   b.rows_,
+		   [&](std::size_t const i) { return a.padded_row(i); },
+		   [&](std::size_t const j) { return b.padded_row(j); },
+		   &a == &b,
+		   out,
+		   true,
+		   threads);
+	}
+
+	auto normalise_rows(euclidean_matrix& m, int const threads) -> std::vector<std::size_t> {
+		auto const rows = gsl_lite::narrow_cast<std::size_t>(m.rows());
+		auto const chunks = std::min(detail::thread_count(threads), std::max(rows, std::size_t{1}));
+		// allocated here, as the workers mustn't throw: room for every index of a chunk (chunks are
+		// at most one longer than rows / chunks)
+		auto skipped = std::vector<std::vector<std::size_t>>(chunks);
+		for (auto& chunk_skipped : skipped) {
+			chunk_skipped.reserve(rows / chunks + 1);
+		}
+		detail::parallel_for(rows,
+		                     chunks,
+		                     [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+			                     for (auto i = begin; i < end; ++i) {
+				                     auto const values = m.row(gsl_lite::narrow_cast<int>(i));
+				                     auto const norm = values.empty() ? 0.0 : detail::scaled_norm(values);
+				                     if (norm == 0) {
+					                     skipped[chunk].push_back(i);
+					                     continue;
+				                     }
+				                     ranges::transform(values, values.begin(), [norm](double const x) {
+					                     return x / norm;
+				                     });
+			                     }
+		                     });
+		auto result = std::vector<std::size_t>();
+		for (auto const& chunk_skipped : skipped) {
+			result.insert(result.end(), chunk_skipped.begin(), chunk_skipped.end());
+		}
+		return result;
+	}
+
+} // namespace comp6771
@@ -13,15 +13,136 @@
 // Class methods code Copyright (c) Vishal Bondwal, Apache 2.0 license
 
 #include "euclidean_vector.hpp"
+#include "dot_kernel.hpp"
+#include "parallel_for.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
 #include <cstddef>
 #include <gsl/gsl-lite.hpp>
 #include <iostream>
+#include <limits>
+#include <new>
 #include <numeric>
 #include <range/v3/functional.hpp>
 #include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 namespace comp6771 {
 
+	// aligned storage
+
+	auto detail::aligned_delete::operator()(double* const magnitudes) const noexcept -> void {
+		::operator delete[](magnitudes, std::align_val_t{storage_alignment});
+	}
+
+	auto detail::make_aligned_array(std::size_t const count) -> aligned_array {
+		auto const padded = padded_size(count);
+		auto magnitudes = aligned_array(static_cast<double*>(
+		   ::operator new[](padded * sizeof(double), std::align_val_t{storage_alignment})));
+		// kernels may read the padding as part of a full-width load, so it must hold zeros
+		auto const padding = std::span<double>(magnitudes.get(), padded).subspan(count);
+		ranges::fill(padding, 0.0);
+		return magnitudes;
+	}
+
+	namespace {
+		// what sits in the cache line in front of shared magnitudes
+		struct storage_header {
+			std::atomic<std::size_t> owners;
+			std::size_t alignment; // of the whole block; needed again to free it
+		};
+		static_assert(sizeof(storage_header) <= detail::storage_alignment);
+
+		// huge page size on x86-64 and (by default) on arm64 Linux
+		constexpr auto huge_page_size = std::size_t{2} << 20;
+
+		// the header sits one storage_alignment block in front of the magnitudes
+		auto block_of(double* const magnitudes) noexcept -> std::byte* {
+			return reinterpret_cast<std::byte*>(magnitudes) - detail::storage_alignment;
+		}
+
+		auto header_of(double* const magnitudes) noexcept -> storage_header& {
+			return *std::launder(reinterpret_cast<storage_header*>(block_of(magnitudes)));
+		}
+	} // namespace
+
+	// With huge_pages, buffers of at least a huge page are aligned to a huge page boundary and the
+	// kernel is asked to back them with transparent huge pages, so a multi-GB vector needs a few
+	// thousand TLB entries instead of a million. Smaller buffers would only waste memory, so they
+	// are allocated as usual. The request is only a hint, and a no-op outside Linux
+	detail::shared_aligned_array::shared_aligned_array(std::size_t const count, bool const huge_pages) {
+		auto const padded = padded_size(count);
+		auto const bytes = storage_alignment + padded * sizeof(double);
+		auto const alignment = huge_pages and bytes >= huge_page_size ? huge_page_size : storage_alignment;
+		auto* const block = static_cast<std::byte*>(::operator new(bytes, std::align_val_t{alignment}));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if (alignment == huge_page_size) {
+			::madvise(block, bytes, MADV_HUGEPAGE); // failure just means ordinary pages
+		}
+#endif
+		new (block) storage_header{{1}, alignment};
+		magnitudes_ = reinterpret_cast<double*>(block + storage_alignment);
+		ranges::fill(std::span<double>(magnitudes_, padded).subspan(count), 0.0);
+	}
+
+	detail::shared_aligned_array::shared_aligned_array(shared_aligned_array const& other) noexcept
+	: magnitudes_(other.magnitudes_) {
+		if (magnitudes_ != nullptr) {
+			header_of(magnitudes_).owners.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	detail::shared_aligned_array::shared_aligned_array(shared_aligned_array&& other) noexcept
+	: magnitudes_(std::exchange(other.magnitudes_, nullptr)) {}
+
+	detail::shared_aligned_array::~shared_aligned_array() noexcept {
+		release();
+	}
+
+	auto detail::shared_aligned_array::operator=(shared_aligned_array const& other) noexcept
+	   -> shared_aligned_array& {
+		if (magnitudes_ != other.magnitudes_) {
+			auto copy = other;
+			std::swap(magnitudes_, copy.magnitudes_);
+		}
+		return *this;
+	}
+
+	auto detail::shared_aligned_array::operator=(shared_aligned_array&& other) noexcept
+	   -> shared_aligned_array& {
+		if (this != &other) {
+			release();
+			magnitudes_ = std::exchange(other.magnitudes_, nullptr);
+		}
+		return *this;
+	}
+
+	// the acquire pairs with the release in other arrays' release(), so once this returns true,
+	// every access made through the arrays that used to share the storage has finished
+	auto detail::shared_aligned_array::unique() const noexcept -> bool {
+		return magnitudes_ == nullptr
+		       or header_of(magnitudes_).owners.load(std::memory_order_acquire) == 1;
+	}
+
+	auto detail::shared_aligned_array::huge_pages() const noexcept -> bool {
+		return magnitudes_ != nullptr and header_of(magnitudes_).alignment == huge_page_size;
+	}
+
+	auto detail::shared_aligned_array::release() noexcept -> void {
+		if (magnitudes_ != nullptr
+		    and header_of(magnitudes_).owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			auto const alignment = header_of(magnitudes_).alignment;
+			::operator delete(block_of(magnitudes_), std::align_val_t{alignment});
+		}
+		magnitudes_ = nullptr;
+	}
+
 	// constructors
 
 	// main constructor, others delegate it, so defining this first (for convenience of reader's
@@ -32,13 +153,35 @@ namespace comp6771 {
 		assert(dimensions >= 0);
 		dimensions_ = gsl_lite::narrow_cast<std::size_t>(dimensions); // losing signedness
 		                                                              // information, so lossy cast
-		// ass2 spec requires we use pointers to double[] instead of std::vector
-		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-		magnitudes_ = std::make_unique<double[]>(dimensions_);
+		magnitudes_ = detail::shared_aligned_array(dimensions_);
 		auto magnitude_span = std::span<double>(magnitudes_.get(), dimensions_);
 		ranges::fill(magnitude_span, magnitude);
 	}
 
+	// same as above, with control over where the storage comes from. Fresh large allocations are
+	// untouched pages, and Linux places each page on the NUMA node of the thread that first
+	// writes it, so filling from several threads spreads the vector over their nodes (and fills
+	// it faster)
+	euclidean_vector::euclidean_vector(int const dimensions,
+	                                   double const magnitude,
+	                                   allocation_policy const policy) {
+		assert(dimensions >= 0);
+		dimensions_ = gsl_lite::narrow_cast<std::size_t>(dimensions);
+		magnitudes_ = detail::shared_aligned_array(dimensions_, policy.huge_pages);
+		auto const magnitude_span = std::span<double>(magnitudes_.get(), dimensions_);
+		// each thread fills whole huge-page-sized runs, so only pages at the run boundaries can be
+		// first touched by a neighbouring thread
+		constexpr auto chunk_granularity = huge_page_size / sizeof(double);
+		auto const granules = (dimensions_ + chunk_granularity - 1) / chunk_granularity;
+		detail::parallel_for(granules,
+		                     detail::thread_count(policy.first_touch_threads),
+		                     [&](std::size_t, std::size_t const first, std::size_t const last) {
+			                     auto const begin = first * chunk_granularity;
+			                     auto const end = std::min(dimensions_, last * chunk_granularity);
+			                     ranges::fill(magnitude_span.subspan(begin, end - begin), magnitude);
+		                     });
+	}
+
 	// explicit dimension-based constructor (specified explicit in header file)
 	euclidean_vector::euclidean_vector(const int dim)
 	: euclidean_vector(dim, 0.0) {} // delegates the previous constructor
@@ -70,7 +213,13 @@ namespace comp6771 {
 
 	// copy constructor
 	euclidean_vector::euclidean_vector(euclidean_vector const& input_evector) noexcept
-	: euclidean_vector(gsl_lite::narrow_cast<int>(input_evector.dimensions_)) {
+	: dimensions_(input_evector.dimensions_)
+	, share_on_copy_(input_evector.share_on_copy_) {
+		if (share_on_copy_) { // copy-on-write: just take another reference to the storage
+			magnitudes_ = input_evector.magnitudes_;
+			return;
+		}
+		allocate(dimensions_, input_evector.magnitudes_.huge_pages());
 		// turn both input object and this object into spans, and copy. Safer than handling pointers
 		auto passed_object_span =
 		   std::span<double>(input_evector.magnitudes_.get(), input_evector.dimensions_);
@@ -84,12 +233,65 @@ namespace comp6771 {
 		                                                    // associated with unique pointer, thus
 		                                                    // automatically invalidating them
 		dimensions_ = input_evector.dimensions_;
+		share_on_copy_ = input_evector.share_on_copy_;
 		input_evector.dimensions_ = 0;
 		// our input vector is in an "unspecified" state now
 	}
 
 	// destructor explicitly declared as default in header file already
 
+	// used by map() and zip_with() (header templates), which write every element themselves
+	euclidean_vector::euclidean_vector(std::size_t const dimensions, uninitialised_tag) {
+		allocate(dimensions);
+	}
+
+	auto euclidean_vector::check_dimensions(euclidean_vector const& lhs, euclidean_vector const& rhs)
+	   -> void {
+		if (lhs.dimensions_ != rhs.dimensions_) {
+			auto except_string = "Dimensions of LHS(" + std::to_string(lhs.dimensions_) + ") and RHS("
+			                     + std::to_string(rhs.dimensions_) + ") do not match";
+			throw euclidean_vector_error(except_string);
+		}
+	}
+
+	// storage helper used by the range constructor (defined in the header, as it is a template).
+	// Doesn't fill the magnitudes, since the caller overwrites every element anyway
+	auto euclidean_vector::allocate(std::size_t const dimensions, bool const huge_pages) -> void {
+		assert(dimensions <= gsl_lite::narrow_cast<std::size_t>(std::numeric_limits<int>::max()));
+		dimensions_ = dimensions;
+		magnitudes_ = detail::shared_aligned_array(dimensions_, huge_pages);
+	}
+
+	// copy-on-write
+
+	auto euclidean_vector::share_on_copy(bool const enable) -> euclidean_vector& {
+		if (not enable) {
+			detach(); // a vector that doesn't share on copy must own its storage outright
+		}
+		share_on_copy_ = enable;
+		return *this;
+	}
+
+	[[nodiscard]] auto euclidean_vector::shares_on_copy() const noexcept -> bool {
+		return share_on_copy_;
+	}
+
+	[[nodiscard]] auto euclidean_vector::uses_huge_pages() const noexcept -> bool {
+		return magnitudes_.huge_pages();
+	}
+
+	[[nodiscard]] auto euclidean_vector::shares_storage_with(euclidean_vector const& other) const noexcept
+	   -> bool {
+		return magnitudes_.get() != nullptr and magnitudes_.get() == other.magnitudes_.get();
+	}
+
+	auto euclidean_vector::unshare() -> void {
+		auto copy = detail::shared_aligned_array(dimensions_, magnitudes_.huge_pages());
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		ranges::copy(magnitude_span, copy.get());
+		magnitudes_ = std::move(copy);
+	}
+
 	// assignment operators
 
 	// copy assignment
@@ -97,9 +299,12 @@ namespace comp6771 {
 		if (this != &input_evector) { // this line handles self-assignment
 			                           // cases (a = a;)
 			dimensions_ = input_evector.dimensions_;
-			// ass2 spec requires we use pointers to double[] instead of std::vector
-			// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-			magnitudes_ = std::make_unique<double[]>(dimensions_);
+			share_on_copy_ = input_evector.share_on_copy_;
+			if (share_on_copy_) { // copy-on-write, as in the copy constructor
+				magnitudes_ = input_evector.magnitudes_;
+				return *this;
+			}
+			magnitudes_ = detail::shared_aligned_array(dimensions_, input_evector.magnitudes_.huge_pages());
 
 			// get spans on both objects and copy
 			auto passed_object_span =
@@ -117,6 +322,7 @@ namespace comp6771 {
 		                                                    // pointer, which goes in unspecified
 		                                                    // state
 		dimensions_ = input_evector.dimensions_;
+		share_on_copy_ = input_evector.share_on_copy_;
 		input_evector.dimensions_ = 0;
 		return *this;
 	}
@@ -142,6 +348,7 @@ namespace comp6771 {
 //V: note following is not const method as returns reference (presumably used to change value). Unlike the one above, which is a getter.
 	auto euclidean_vector::operator[](const int index) -> double& {
 		assert(index >= 0 && index < gsl_lite::narrow_cast<int>(dimensions_));
+		detach();
 		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(index)];
 	}
 
@@ -154,6 +361,7 @@ namespace comp6771 {
 
 	auto euclidean_vector::operator-() const -> euclidean_vector { // returns a copy, so is const
 		auto result = euclidean_vector(*this); // initialize result vector with this object
+		result.detach(); // the copy shares our storage if we are copy-on-write
 		auto result_span = std::span<double>(result.magnitudes_.get(), result.dimensions_);
 
 //V: the following is one overload of transform(), there are more, one is in the next function. This one uses begin & end iterators for source range, and begin iterator for destination.
@@ -177,6 +385,7 @@ namespace comp6771 {
 		}
 
 		// get spans on this object(acts as accumulator) and the other source vector
+		detach();
 		auto sum_span = std::span<double>(magnitudes_.get(), dimensions_);
 		auto rhs_span = std::span<double>(rhs.magnitudes_.get(), rhs.dimensions_);
 		// and add them into sum (which is a span over this object)
@@ -194,6 +403,7 @@ namespace comp6771 {
 		}
 
 		// get spans on this result vector and the other source vector
+		detach();
 		auto diff_span = std::span<double>(magnitudes_.get(), dimensions_);
 		auto rhs_span = std::span<double>(rhs.magnitudes_.get(), rhs.dimensions_);
 		// and subtract them into diff (this vector)
@@ -206,6 +416,7 @@ namespace comp6771 {
 	// Friend functions handle commutative syntax cases
 	auto euclidean_vector::operator*=(double const scalar) -> euclidean_vector& {
 		// get span on this object, where product would be stored
+		detach();
 		auto product_span = std::span<double>(magnitudes_.get(), dimensions_);
 		ranges::transform(product_span.begin(), // source
 		                  product_span.end(),
@@ -222,6 +433,7 @@ namespace comp6771 {
 			throw("Invalid vector division by 0");
 		}
 		// get span on this object, where quotient would be stored
+		detach();
 		auto quotient_span = std::span<double>(magnitudes_.get(), dimensions_);
 		ranges::transform(quotient_span.begin(), // source
 		                  quotient_span.end(),
@@ -230,6 +442,85 @@ namespace comp6771 {
 		return *this;
 	}
 
+	// fused in-place updates. Each is a single ranges::transform over spans of the two (or three)
+	// operands, writing straight back into this object, so there is no temporary vector and the
+	// loop body is simple enough for the compiler to vectorise
+
+	auto euclidean_vector::axpy(double const alpha, euclidean_vector const& x) -> euclidean_vector& {
+		if (dimensions_ != x.dimensions_) {
+			auto except_string = "Dimensions of LHS(" + std::to_string(dimensions_) + ") and RHS("
+			                     + std::to_string(x.dimensions_) + ") do not match";
+			throw euclidean_vector_error(except_string);
+		}
+
+		detach();
+		auto y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		auto x_span = std::span<double>(x.magnitudes_.get(), x.dimensions_);
+		ranges::transform(y_span, x_span, y_span.begin(), [alpha](double const y, double const xi) {
+			return y + alpha * xi;
+		});
+		return *this;
+	}
+
+	auto euclidean_vector::axpby(double const alpha, euclidean_vector const& x, double const beta)
+	   -> euclidean_vector& {
+		if (dimensions_ != x.dimensions_) {
+			auto except_string = "Dimensions of LHS(" + std::to_string(dimensions_) + ") and RHS("
+			                     + std::to_string(x.dimensions_) + ") do not match";
+			throw euclidean_vector_error(except_string);
+		}
+
+		detach();
+		auto y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		auto x_span = std::span<double>(x.magnitudes_.get(), x.dimensions_);
+		ranges::transform(y_span, x_span, y_span.begin(), [alpha, beta](double const y, double const xi) {
+			return alpha * xi + beta * y;
+		});
+		return *this;
+	}
+
+	// moves this vector a fraction t of the way towards target (t = 0 leaves it unchanged, t = 1
+	// makes it equal to target). Not using std::lerp, as its extra guarantees (exactness at the
+	// end points, monotonicity) need branches that stop the loop from vectorising
+	auto euclidean_vector::lerp(euclidean_vector const& target, double const t) -> euclidean_vector& {
+		if (dimensions_ != target.dimensions_) {
+			auto except_string = "Dimensions of LHS(" + std::to_string(dimensions_) + ") and RHS("
+			                     + std::to_string(target.dimensions_) + ") do not match";
+			throw euclidean_vector_error(except_string);
+		}
+
+		detach();
+		auto y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		auto x_span = std::span<double>(target.magnitudes_.get(), target.dimensions_);
+		ranges::transform(y_span, x_span, y_span.begin(), [t](double const y, double const xi) {
+			return y + t * (xi - y);
+		});
+		return *this;
+	}
+
+	// element-wise (Hadamard) multiply-add: this[i] += a[i] * b[i]
+	auto euclidean_vector::fma(euclidean_vector const& a, euclidean_vector const& b)
+	   -> euclidean_vector& {
+		if (dimensions_ != a.dimensions_ or dimensions_ != b.dimensions_) {
+			auto except_string = "Dimensions of LHS(" + std::to_string(dimensions_) + ") and RHS("
+			                     + std::to_string(a.dimensions_) + ", " + std::to_string(b.dimensions_)
+			                     + ") do not match";
+			throw euclidean_vector_error(except_string);
+		}
+
+		detach();
+		auto y_span = std::span<double>(magnitudes_.get(), dimensions_);
+		auto a_span = std::span<double>(a.magnitudes_.get(), a.dimensions_);
+		auto b_span = std::span<double>(b.magnitudes_.get(), b.dimensions_);
+		// ranges::transform only takes two input ranges, and we need three (y, a and b), so this is
+		// the one place a plain indexed loop is clearer. It is still a straight-line loop over spans
+		// that the compiler vectorises
+		for (auto i = std::size_t{0}; i < dimensions_; ++i) {
+			y_span[i] += a_span[i] * b_span[i];
+		}
+		return *this;
+	}
+
 	// type conversion functions
 
 	euclidean_vector::operator std::vector<double>() const noexcept {
@@ -269,6 +560,7 @@ namespace comp6771 {
 			throw euclidean_vector_error(except_string);
 		}
 
+		detach();
 		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(index)];
 	}
 
@@ -276,6 +568,245 @@ namespace comp6771 {
 		return gsl_lite::narrow_cast<int>(dimensions_);
 	}
 
+	// reductions
+
+	// std::reduce and transform_reduce may add in any order, which is what lets them vectorise
+	// (a strict left-to-right std::accumulate can't be, without -ffast-math)
+
+	[[nodiscard]] auto euclidean_vector::sum() const noexcept -> double {
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		return std::reduce(magnitude_span.begin(), magnitude_span.end(), 0.0);
+	}
+
+	[[nodiscard]] auto euclidean_vector::min() const -> double {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a minimum");
+		}
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		return std::reduce(magnitude_span.begin() + 1,
+		                   magnitude_span.end(),
+		                   magnitude_span.front(),
+		                   [](double const x, double const y) { return std::min(x, y); });
+	}
+
+	[[nodiscard]] auto euclidean_vector::max() const -> double {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a maximum");
+		}
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		return std::reduce(magnitude_span.begin() + 1,
+		                   magnitude_span.end(),
+		                   magnitude_span.front(),
+		                   [](double const x, double const y) { return std::max(x, y); });
+	}
+
+	[[nodiscard]] auto euclidean_vector::argmin() const -> int {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a minimum");
+		}
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		return gsl_lite::narrow_cast<int>(ranges::min_element(magnitude_span)
+		                                  - magnitude_span.begin());
+	}
+
+	[[nodiscard]] auto euclidean_vector::argmax() const -> int {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a maximum");
+		}
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		return gsl_lite::narrow_cast<int>(ranges::max_element(magnitude_span)
+		                                  - magnitude_span.begin());
+	}
+
+	[[nodiscard]] auto euclidean_vector::mean() const -> double {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a mean");
+		}
+		return sum() / static_cast<double>(dimensions_);
+	}
+
+	[[nodiscard]] auto euclidean_vector::variance() const -> double {
+		return summarise().variance;
+	}
+
+	// hashing
+
+	namespace {
+		// 64-bit mixing constants (from xxHash64 and splitmix64)
+		constexpr auto hash_prime_1 = std::uint64_t{0x9E3779B185EBCA87};
+		constexpr auto hash_prime_2 = std::uint64_t{0xC2B2AE3D27D4EB4F};
+
+		auto hash_round(std::uint64_t const accumulator, std::uint64_t const word) noexcept
+		   -> std::uint64_t {
+			return std::rotl(accumulator + word * hash_prime_2, 31) * hash_prime_1;
+		}
+
+		auto hash_finalise(std::uint64_t h) noexcept -> std::uint64_t {
+			h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9;
+			h = (h ^ (h >> 27)) * 0x94D049BB133111EB;
+			return h ^ (h >> 31);
+		}
+	} // namespace
+
+	// Four lanes, as in xxHash: element i feeds lane i % 4, so the four multiply chains are
+	// independent and run side by side. Adding 0.0 turns -0.0 into 0.0 before the bits are
+	// taken, so the hash agrees with operator==
+	[[nodiscard]] auto euclidean_vector::content_hash() const noexcept -> std::uint64_t {
+		constexpr auto lanes = std::size_t{4};
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		auto const word = [&](std::size_t const i) {
+			return std::bit_cast<std::uint64_t>(magnitude_span[i] + 0.0);
+		};
+
+		auto accumulators = std::array<std::uint64_t, lanes>{hash_prime_1, hash_prime_2, 0, ~hash_prime_1};
+		auto const full = dimensions_ - dimensions_ % lanes;
+		for (auto i = std::size_t{0}; i < full; i += lanes) {
+			for (auto lane = std::size_t{0}; lane < lanes; ++lane) {
+				accumulators[lane] = hash_round(accumulators[lane], word(i + lane));
+			}
+		}
+		for (auto i = full; i < dimensions_; ++i) {
+			accumulators[0] = hash_round(accumulators[0], word(i));
+		}
+
+		auto h = std::rotl(accumulators[0], 1) + std::rotl(accumulators[1], 7)
+		         + std::rotl(accumulators[2], 12) + std::rotl(accumulators[3], 18);
+		return hash_finalise(h ^ dimensions_);
+	}
+
+	namespace {
+		// summary of one contiguous chunk. mean and m2 (sum of squared deviations from the mean)
+		// rather than sums of x and x^2, so chunks combine without cancellation
+		struct partial_summary {
+			std::size_t count;
+			double sum;
+			double mean;
+			double m2;
+			double min;
+			double max;
+			std::size_t argmin;
+			std::size_t argmax;
+		};
+
+		// Single pass over a non-empty chunk. The work is spread over four lanes (element i goes to
+		// lane i % 4), written without branches, so the compiler can keep each lane array in one
+		// SIMD register. Deviations are taken from the chunk's first element, which keeps the
+		// sum of squares well conditioned when the values sit far from zero.
+		auto summarise_chunk(std::span<double const> const values, std::size_t const first_index)
+		   -> partial_summary {
+			constexpr auto lanes = std::size_t{4};
+			auto const shift = values.front();
+			auto sums = std::array<double, lanes>{};
+			auto shifted_sums = std::array<double, lanes>{};
+			auto shifted_squares = std::array<double, lanes>{};
+			auto mins = std::array<double, lanes>{};
+			auto maxs = std::array<double, lanes>{};
+			auto argmins = std::array<std::size_t, lanes>{};
+			auto argmaxs = std::array<std::size_t, lanes>{};
+			mins.fill(shift);
+			maxs.fill(shift);
+
+			auto const visit = [&](std::size_t const lane, std::size_t const i) {
+				auto const x = values[i];
+				auto const deviation = x - shift;
+				sums[lane] += x;
+				shifted_sums[lane] += deviation;
+				shifted_squares[lane] += deviation * deviation;
+				auto const lower = x < mins[lane];
+				mins[lane] = lower ? x : mins[lane];
+				argmins[lane] = lower ? i : argmins[lane];
+				auto const higher = x > maxs[lane];
+				maxs[lane] = higher ? x : maxs[lane];
+				argmaxs[lane] = higher ? i : argmaxs[lane];
+			};
+			auto const full = values.size() - values.size() % lanes;
+			for (auto i = std::size_t{0}; i < full; i += lanes) {
+				for (auto lane = std::size_t{0}; lane < lanes; ++lane) {
+					visit(lane, i + lane);
+				}
+			}
+			for (auto i = full; i < values.size(); ++i) {
+				visit(0, i);
+			}
+
+			auto result = partial_summary{values.size(), 0.0, 0.0, 0.0, shift, shift, 0, 0};
+			auto shifted_sum = 0.0;
+			auto shifted_square = 0.0;
+			for (auto lane = std::size_t{0}; lane < lanes; ++lane) {
+				result.sum += sums[lane];
+				shifted_sum += shifted_sums[lane];
+				shifted_square += shifted_squares[lane];
+				// ties go to the lower index, so argmin/argmax are first occurrences
+				if (mins[lane] < result.min or (mins[lane] == result.min and argmins[lane] < result.argmin))
+				{
+					result.min = mins[lane];
+					result.argmin = argmins[lane];
+				}
+				if (maxs[lane] > result.max or (maxs[lane] == result.max and argmaxs[lane] < result.argmax))
+				{
+					result.max = maxs[lane];
+					result.argmax = argmaxs[lane];
+				}
+			}
+			auto const count = static_cast<double>(values.size());
+			result.mean = shift + shifted_sum / count;
+			result.m2 = std::max(0.0, shifted_square - shifted_sum * shifted_sum / count);
+			result.argmin += first_index;
+			result.argmax += first_index;
+			return result;
+		}
+
+		// Chan et al.'s pairwise update: merges two chunk summaries (lhs covers the lower indexes)
+		auto combine(partial_summary const& lhs, partial_summary const& rhs) -> partial_summary {
+			auto const count = lhs.count + rhs.count;
+			auto const delta = rhs.mean - lhs.mean;
+			auto const lhs_share = static_cast<double>(lhs.count);
+			auto const rhs_share = static_cast<double>(rhs.count);
+			auto result = lhs;
+			result.count = count;
+			result.sum += rhs.sum;
+			result.mean += delta * rhs_share / static_cast<double>(count);
+			result.m2 += rhs.m2 + delta * delta * lhs_share * rhs_share / static_cast<double>(count);
+			if (rhs.min < lhs.min) {
+				result.min = rhs.min;
+				result.argmin = rhs.argmin;
+			}
+			if (rhs.max > lhs.max) {
+				result.max = rhs.max;
+				result.argmax = rhs.argmax;
+			}
+			return result;
+		}
+	} // namespace
+
+	[[nodiscard]] auto euclidean_vector::summarise(int const threads) const -> summary_statistics {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have summary "
+			                             "statistics");
+		}
+
+		// each chunk is summarised on its own thread, then the chunks are combined in index order,
+		// so the result only depends on the number of chunks, never on timing
+		auto const magnitude_span = std::span<double const>(magnitudes_.get(), dimensions_);
+		auto const chunks = std::min(detail::thread_count(threads), dimensions_);
+		auto partials = std::vector<partial_summary>(chunks);
+		detail::parallel_for(dimensions_,
+		                     chunks,
+		                     [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+			                     partials[chunk] =
+			                        summarise_chunk(magnitude_span.subspan(begin, end - begin), begin);
+		                     });
+
+		auto const total = std::accumulate(partials.begin() + 1, partials.end(), partials.front(), combine);
+		return summary_statistics{total.sum,
+		                          total.min,
+		                          total.max,
+		                          gsl_lite::narrow_cast<int>(total.argmin),
+		                          gsl_lite::narrow_cast<int>(total.argmax),
+		                          total.mean,
+		                          total.m2 / static_cast<double>(total.count)};
+	}
+
 	// friend function operator overloads
 
 	// these are given to be friend functions in spec, so directly accessing private variables for
@@ -308,6 +839,7 @@ namespace comp6771 {
 		}
 
 		auto sum = euclidean_vector(lhs); // initialize result vector with one source vector
+		sum.detach(); // shares lhs's storage if lhs is copy-on-write
 		// get spans on this accumulator and the other source vector
 		auto sum_span = std::span<double>(sum.magnitudes_.get(), sum.dimensions_);
 		auto rhs_span = std::span<double>(rhs.magnitudes_.get(), rhs.dimensions_);
@@ -326,6 +858,7 @@ namespace comp6771 {
 		}
 
 		auto diff_vector = euclidean_vector(lhs); // initialize result vector with one source vector
+		diff_vector.detach();
 		// get spans on this result vector and the other source vector
 		auto diff_span = std::span<double>(diff_vector.magnitudes_.get(), diff_vector.dimensions_);
 		auto rhs_span = std::span<double>(rhs.magnitudes_.get(), rhs.dimensions_);
@@ -338,6 +871,7 @@ namespace comp6771 {
 	// scalar is not passed by reference because it would cause problems if it's an rvalue
 	auto operator*(euclidean_vector const& ev, double const scalar) -> euclidean_vector {
 		auto product_vector = euclidean_vector(ev); // initialize result vector
+		product_vector.detach();
 		auto product_span =
 		   std::span<double>(product_vector.magnitudes_.get(), product_vector.dimensions_);
 		ranges::transform(product_span.begin(), // source
@@ -359,6 +893,7 @@ namespace comp6771 {
 			throw("Invalid vector division by 0");
 		}
 		auto quotient = euclidean_vector(ev); // initialize result vector
+		quotient.detach();
 		auto quotient_span = std::span<double>(quotient.magnitudes_.get(), quotient.dimensions_);
 		ranges::transform(quotient_span.begin(), // source
 		                  quotient_span.end(),
@@ -386,6 +921,22 @@ namespace comp6771 {
 		return os;
 	}
 
+	// element-wise helpers. Plain lambdas, so the compiler can inline and vectorise them inside
+	// map()/zip_with()
+
+	auto hadamard(euclidean_vector const& lhs, euclidean_vector const& rhs) -> euclidean_vector {
+		return zip_with(lhs, rhs, ranges::multiplies{});
+	}
+
+	auto abs(euclidean_vector const& v) -> euclidean_vector {
+		return map(v, [](double const x) { return std::abs(x); });
+	}
+
+	auto clamp(euclidean_vector const& v, double const low, double const high) -> euclidean_vector {
+		assert(low <= high);
+		return map(v, [low, high](double const x) { return std::clamp(x, low, high); });
+	}
+
 	// utility functions
 
 	// starting with dot() because it is used in norm calculation, so is helpful to understand first
@@ -403,14 +954,16 @@ namespace comp6771 {
 		}
 		assert(lhs.dimensions() > 0);
 
-		// converting both euclidean vectors to std vectors, as much faster than accessing with at()
-		// or [] again and again (note that this is not a friend fn, so can't access directly)
-		auto xvector = std::vector<double>(lhs);
-		auto yvector = std::vector<double>(rhs);
-		auto result = 0.0;
-		result = std::inner_product(xvector.begin(), xvector.end(), yvector.begin(), 0.0);
+		// straight over the storage through the range interface, no copies. Still strictly left to
+		// right, so results are the same as they always were (see reproducible_dot and the
+		// unchecked overload for faster, vectorised versions)
+		return std::inner_product(lhs.begin(), lhs.end(), rhs.begin(), 0.0);
+	}
 
-		return result;
+	auto dot(euclidean_vector const& lhs, euclidean_vector const& rhs, unchecked_t) noexcept -> double {
+		assert(lhs.dimensions_ == rhs.dimensions_);
+		return detail::dot(std::span<double const>(lhs.magnitudes_.get(), lhs.dimensions_),
+		                   std::span<double const>(rhs.magnitudes_.get(), rhs.dimensions_));
 	}
 
 	// Returns the Euclidean norm of the vector as a double. The Euclidean norm is the
@@ -426,6 +979,210 @@ namespace comp6771 {
 		return sqrt(sqnorm);
 	}
 
+	// Overflow/underflow-safe norm. norm_mode::scaled first tries the plain sum of squares (one
+	// vectorised pass); that is only wrong when it overflowed, or when it is so small that squares
+	// lost to underflow could matter. Only then does it make a second pass, after finding the
+	// largest magnitude: everything is scaled by a power of two that brings the largest magnitude
+	// near 1 (exact, so no rounding is added), squared and summed, and the scale is undone on the
+	// square root. Both passes use transform_reduce, which may reorder the additions, so they
+	// vectorise without -ffast-math.
+	auto euclidean_norm(euclidean_vector const& v, norm_mode const mode) -> double {
+		if (mode == norm_mode::fast) {
+			return euclidean_norm(v);
+		}
+		if (v.dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a norm");
+		}
+		return detail::scaled_norm(std::span<double const>(v.magnitudes_.get(), v.dimensions_));
+	}
+
+	auto detail::scaled_norm(std::span<double const> const magnitude_span) -> double {
+		auto const sum_of_squares = [&magnitude_span](double const scale) {
+			return std::transform_reduce(magnitude_span.begin(),
+			                             magnitude_span.end(),
+			                             0.0,
+			                             std::plus<>(),
+			                             [scale](double const x) { return (x * scale) * (x * scale); });
+		};
+
+		// a sum at least this big can only have lost a negligible part of itself to underflow
+		auto const safe_minimum = std::numeric_limits<double>::min()
+		                          / std::numeric_limits<double>::epsilon()
+		                          * static_cast<double>(magnitude_span.size());
+		auto const plain = sum_of_squares(1.0);
+		if (std::isfinite(plain) and plain >= safe_minimum) {
+			return std::sqrt(plain);
+		}
+
+		auto const largest = std::transform_reduce(magnitude_span.begin(),
+		                                           magnitude_span.end(),
+		                                           0.0,
+		                                           [](double const x, double const y) {
+			                                           return std::max(x, y);
+		                                           },
+		                                           [](double const x) { return std::abs(x); });
+		if (largest == 0.0 or not std::isfinite(largest)) { // all zero, or an inf: nothing to rescale
+			return std::isnan(plain) ? plain : largest;
+		}
+
+		auto const exponent = std::ilogb(largest);
+		return std::ldexp(std::sqrt(sum_of_squares(std::ldexp(1.0, -exponent))), exponent);
+	}
+
+	// reproducible reductions
+
+	namespace {
+		// adds the (non-empty) values as a balanced binary tree. The shape depends only on the number of
+		// values, and pairwise addition also keeps the rounding error down to O(log n)
+		auto pairwise_sum(std::span<double const> const values) noexcept -> double {
+			if (values.size() == 1) {
+				return values.front();
+			}
+			auto const half = values.size() / 2;
+			return pairwise_sum(values.first(half)) + pairwise_sum(values.subspan(half));
+		}
+
+		// block_fn(offset, size) -> double is computed for each reproducible_block-sized block of
+		// [0, count), with the blocks shared between threads, and the results summed pairwise
+		template<typename BlockFn>
+		auto reproducible_reduce(std::size_t const count, int const threads, BlockFn const& block_fn)
+		   -> double {
+			if (count == 0) {
+				return 0.0;
+			}
+			auto const blocks = (count + reproducible_block - 1) / reproducible_block;
+			auto partials = std::vector<double>(blocks);
+			detail::parallel_for(blocks,
+			                     detail::thread_count(threads),
+			                     [&](std::size_t, std::size_t const first, std::size_t const last) {
+				                     for (auto block = first; block < last; ++block) {
+					                     auto const begin = block * reproducible_block;
+					                     auto const end = std::min(count, begin + reproducible_block);
+					                     partials[block] = block_fn(begin, end - begin);
+				                     }
+			                     });
+			return pairwise_sum(partials);
+		}
+	} // namespace
+
+	auto reproducible_sum(euclidean_vector const& v, int const threads) -> double {
+		auto const magnitude_span = std::span<double const>(v.magnitudes_.get(), v.dimensions_);
+		return reproducible_reduce(v.dimensions_, threads, [&](std::size_t const offset, std::size_t const size) {
+			return detail::lane_sum(magnitude_span.subspan(offset, size));
+		});
+	}
+
+	auto reproducible_dot(euclidean_vector const& lhs, euclidean_vector const& rhs, int const threads)
+	   -> double {
+		euclidean_vector::check_dimensions(lhs, rhs);
+		assert(lhs.dimensions_ > 0);
+		auto const lhs_span = std::span<double const>(lhs.magnitudes_.get(), lhs.dimensions_);
+		auto const rhs_span = std::span<double const>(rhs.magnitudes_.get(), rhs.dimensions_);
+		return reproducible_reduce(lhs.dimensions_, threads, [&](std::size_t const offset, std::size_t const size) {
+			return detail::dot(lhs_span.subspan(offset, size), rhs_span.subspan(offset, size));
+		});
+	}
+
+	// Same fallback as norm_mode::scaled: rescaling by a power of two is exact, and the largest
+	// magnitude doesn't depend on the order it is searched in, so the result stays reproducible
+	auto reproducible_norm(euclidean_vector const& v, int const threads) -> double {
+		if (v.dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a norm");
+		}
+
+		auto const magnitude_span = std::span<double const>(v.magnitudes_.get(), v.dimensions_);
+		auto const sum_of_squares = [&](double const scale) {
+			return reproducible_reduce(v.dimensions_, threads, [&](std::size_t const offset, std::size_t const size) {
+				auto const block = magnitude_span.subspan(offset, size);
+				if (scale == 1.0) {
+					return detail::dot(block, block);
+				}
+				auto scaled = std::array<double, reproducible_block>{};
+				ranges::transform(block, scaled.begin(), [scale](double const x) { return x * scale; });
+				auto const scaled_block = std::span<double const>(scaled).first(size);
+				return detail::dot(scaled_block, scaled_block);
+			});
+		};
+
+		auto const safe_minimum = std::numeric_limits<double>::min()
+		                          / std::numeric_limits<double>::epsilon()
+		                          * static_cast<double>(v.dimensions_);
+		auto const plain = sum_of_squares(1.0);
+		if (std::isfinite(plain) and plain >= safe_minimum) {
+			return std::sqrt(plain);
+		}
+
+		auto const largest = std::transform_reduce(magnitude_span.begin(),
+		                                           magnitude_span.end(),
+		                                           0.0,
+		                                           [](double const x, double const y) {
+			                                           return std::max(x, y);
+		                                           },
+		                                           [](double const x) { return std::abs(x); });
+		if (largest == 0.0 or not std::isfinite(largest)) {
+			return std::isnan(plain) ? plain : largest;
+		}
+
+		auto const exponent = std::ilogb(largest);
+		return std::ldexp(std::sqrt(sum_of_squares(std::ldexp(1.0, -exponent))), exponent);
+	}
+
+	// in-place normalisation
+
+	// Same checks and arithmetic as unit() (scaled norm, then a division per magnitude), so
+	// v.normalise() == unit(v) exactly, but with no new storage
+	auto euclidean_vector::normalise() -> euclidean_vector& {
+		if (dimensions_ == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit "
+			                             "vector");
+		}
+		auto const norm = euclidean_norm(*this, norm_mode::scaled);
+		if (norm == 0) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a "
+			                             "unit vector");
+		}
+		detach();
+		return divide(norm, unchecked);
+	}
+
+	// Each vector is finished (norm, then scale) before moving on, so the scaling pass reads it
+	// back from cache rather than memory. The zero-norm indexes are gathered per chunk and joined
+	// in chunk order, so they come out ascending whatever the thread count
+	auto normalise(std::span<euclidean_vector> const vectors, int const threads)
+	   -> std::vector<std::size_t> {
+		auto const chunks = std::min(detail::thread_count(threads), std::max(vectors.size(), std::size_t{1}));
+		// Everything that can allocate is done here, as the workers mustn't throw: room for every
+		// index of a chunk (chunks are at most one longer than size / chunks), and a buffer of its
+		// own for every vector sharing copy-on-write storage (non-const data() detaches)
+		auto skipped = std::vector<std::vector<std::size_t>>(chunks);
+		for (auto& chunk_skipped : skipped) {
+			chunk_skipped.reserve(vectors.size() / chunks + 1);
+		}
+		for (auto& v : vectors) {
+			static_cast<void>(v.data());
+		}
+		detail::parallel_for(vectors.size(),
+		                     chunks,
+		                     [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+			                     for (auto i = begin; i < end; ++i) {
+				                     auto& v = vectors[i];
+				                     auto const norm = v.dimensions() == 0
+				                                          ? 0.0
+				                                          : euclidean_norm(v, norm_mode::scaled);
+				                     if (norm == 0) {
+					                     skipped[chunk].push_back(i);
+					                     continue;
+				                     }
+				                     v.divide(norm, unchecked);
+			                     }
+		                     });
+		auto result = std::vector<std::size_t>();
+		for (auto const& chunk_skipped : skipped) {
+			result.insert(result.end(), chunk_skipped.begin(), chunk_skipped.end());
+		}
+		return result;
+	}
+
 	// Returns a Euclidean vector that is the unit vector of v. The magnitude for each
 	// dimension in the unit vector is the original vector's magnitude divided by the Euclidean norm.
 	auto unit(euclidean_vector const& v) -> euclidean_vector {
@@ -434,23 +1191,16 @@ namespace comp6771 {
 			                             "vector");
 		}
 
-		auto norm = euclidean_norm(v);
+		// scaled, so vectors with huge or tiny magnitudes still have a unit vector
+		auto norm = euclidean_norm(v, norm_mode::scaled);
 
 		if (norm == 0) {
 			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a "
 			                             "unit vector");
 		}
 
-		// convert euclidean to std vector, as is much faster to access, than to access elements again
-		// and again with [] or at()
-		auto vr = std::vector<double>(v);
-		ranges::transform(vr.begin(), // source
-		                  vr.end(),
-		                  vr.begin(), // destination
-		                  [&norm](auto& c) { return c / norm; });
-
-		// now construct a euclidean vector with this std::vector, and return
-		return (euclidean_vector(vr.begin(), vr.end()));
+		// written straight into the new vector's storage, with no intermediate copy
+		return map(v, [norm](double const c) { return c / norm; });
 	}
 
 } // namespace comp6771
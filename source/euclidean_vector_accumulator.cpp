@@ -0,0 +1,85 @@
+// Sharded accumulation of euclidean_vectors from many threads.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "euclidean_vector_accumulator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace comp6771 {
+
+	namespace {
+		auto next_accumulator_id() noexcept -> std::uint64_t {
+			static auto counter = std::atomic<std::uint64_t>(0);
+			return counter.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// each thread remembers the shard it last used, so repeated adds into one accumulator
+		// never touch the accumulator's mutex
+		struct cached_shard {
+			std::uint64_t accumulator_id = ~std::uint64_t{0};
+			euclidean_vector* sum = nullptr;
+		};
+		thread_local auto last_shard = cached_shard{};
+	} // namespace
+
+	euclidean_vector_accumulator::euclidean_vector_accumulator(int const dimensions)
+	: dimensions_(dimensions)
+	, id_(next_accumulator_id()) {
+		assert(dimensions >= 0);
+	}
+
+	auto euclidean_vector_accumulator::local() -> euclidean_vector& {
+		if (last_shard.accumulator_id == id_) {
+			return *last_shard.sum;
+		}
+		auto& sum = find_or_add_shard();
+		last_shard = cached_shard{id_, &sum};
+		return sum;
+	}
+
+	auto euclidean_vector_accumulator::add(euclidean_vector const& v) -> void {
+		local() += v;
+	}
+
+	auto euclidean_vector_accumulator::find_or_add_shard() -> euclidean_vector& {
+		auto const owner = std::this_thread::get_id();
+		auto const lock = std::lock_guard(mutex_);
+		auto const existing = std::find_if(shards_.begin(), shards_.end(), [owner](auto const& s) {
+			return s->owner == owner;
+		});
+		if (existing != shards_.end()) {
+			return (*existing)->sum; // this thread used another accumulator in between
+		}
+		shards_.push_back(std::make_unique<shard>(shard{owner, euclidean_vector(dimensions_)}));
+		return shards_.back()->sum;
+	}
+
+	[[nodiscard]] auto euclidean_vector_accumulator::total() const -> euclidean_vector {
+		auto result = euclidean_vector(dimensions_);
+		auto const lock = std::lock_guard(mutex_);
+		for (auto const& s : shards_) {
+			result += s->sum;
+		}
+		return result;
+	}
+
+	auto euclidean_vector_accumulator::reset() -> void {
+		auto const lock = std::lock_guard(mutex_);
+		for (auto const& s : shards_) {
+			s->sum.transform([](double) { return 0.0; });
+		}
+	}
+
+	[[nodiscard]] auto euclidean_vector_accumulator::dimensions() const noexcept -> int {
+		return dimensions_;
+	}
+
+	[[nodiscard]] auto euclidean_vector_accumulator::shards() const -> std::size_t {
+		auto const lock = std::lock_guard(mutex_);
+		return shards_.size();
+	}
+
+} // namespace comp6771
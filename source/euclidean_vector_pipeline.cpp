@@ -0,0 +1,57 @@
+// Coroutine stages for streaming euclidean_vectors through read -> normalise -> score -> write,
+// one vector at a time. See euclidean_vector_pipeline.hpp for how the stages fit together.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "euclidean_vector_pipeline.hpp"
+
+#include <range/v3/view/istream.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+
+	auto read_vectors(std::istream& in) -> generator<euclidean_vector> {
+		auto line = std::string();
+		auto line_number = std::size_t{0};
+		while (std::getline(in, line)) {
+			++line_number;
+			auto line_stream = std::istringstream(line);
+			// the range constructor reads straight off the stream, so each line is parsed once,
+			// without an intermediate std::vector
+			auto ev = euclidean_vector(ranges::istream_view<double>(line_stream));
+			if (not line_stream.eof()) { // stopped before the end of the line, so bad input
+				throw euclidean_vector_error("Could not read a euclidean_vector from line "
+				                             + std::to_string(line_number));
+			}
+			if (ev.dimensions() == 0) { // blank line
+				continue;
+			}
+			co_yield std::move(ev);
+		}
+	}
+
+	auto normalise(generator<euclidean_vector> vectors) -> generator<euclidean_vector> {
+		for (auto& ev : vectors) {
+			co_yield std::move(ev.normalise()); // in place: no new storage per vector
+		}
+	}
+
+	// query is taken by value, so it lives in the coroutine frame for as long as the stage does
+	auto score(generator<euclidean_vector> vectors, euclidean_vector query) -> generator<double> {
+		for (auto& ev : vectors) {
+			co_yield dot(ev, query);
+		}
+	}
+
+	auto write_scores(generator<double> scores, std::ostream& out) -> std::size_t {
+		auto written = std::size_t{0};
+		for (auto const score_value : scores) {
+			out << score_value << '\n';
+			++written;
+		}
+		return written;
+	}
+
+} // namespace comp6771
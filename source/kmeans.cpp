@@ -0,0 +1,409 @@
+// k-means clustering: k-means++ seeding, then Lloyd or mini-batch iterations.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "kmeans.hpp"
+
+#include "dot_kernel.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <gsl/gsl-lite.hpp>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+
+	namespace {
+		// k-means++ works through the points in blocks of this many. The sampling weights are
+		// summed per block and the block sums combined in order, so which point gets picked doesn't
+		// depend on how the blocks were split between threads
+		constexpr auto seeding_block = std::size_t{4096};
+
+		auto check_options(euclidean_matrix const& points, kmeans_options const& options) -> void {
+			if (options.clusters < 1 or options.clusters > points.rows()) {
+				throw euclidean_vector_error("Cannot make " + std::to_string(options.clusters)
+				                             + " clusters from " + std::to_string(points.rows())
+				                             + " points");
+			}
+			if (points.columns() == 0) {
+				throw euclidean_vector_error("Points with no dimensions cannot be clustered");
+			}
+			if (options.max_iterations < 0) {
+				throw euclidean_vector_error("max_iterations cannot be negative");
+			}
+		}
+
+		auto point(euclidean_matrix const& points, std::size_t const i) -> std::span<double const> {
+			return points.row(gsl_lite::narrow_cast<int>(i));
+		}
+
+		struct nearest_centroid {
+			int cluster;
+			double distance; // squared
+		};
+
+		auto nearest(euclidean_matrix const& centroids, std::span<double const> const x) noexcept
+		   -> nearest_centroid {
+			auto result = nearest_centroid{0, std::numeric_limits<double>::infinity()};
+			for (auto c = 0; c < centroids.rows(); ++c) {
+				auto const distance = detail::squared_distance(centroids.row(c), x);
+				if (distance < result.distance) {
+					result = {c, distance};
+				}
+			}
+			return result;
+		}
+
+		// Random numbers straight from the engine's output rather than through the standard
+		// distributions, whose algorithms the standard leaves to each library: mt19937_64's output is
+		// fixed by the standard, so a seed gives the same run with any standard library.
+		// A uniform double in [0, 1), from the top 53 bits
+		auto uniform(std::mt19937_64& engine) -> double {
+			return static_cast<double>(engine() >> 11) * 0x1p-53;
+		}
+
+		// a uniform index in [0, count). The bias from 2^64 not being a multiple of count is below
+		// count / 2^64, far too small to matter here
+		auto uniform_index(std::mt19937_64& engine, std::size_t const count) -> std::size_t {
+			return static_cast<std::size_t>(engine() % count);
+		}
+
+		// Picks index i with probability weights[i] / total (total being the sum of block_sums).
+		// Weights that are all zero (every point already a centroid) fall back to a uniform pick
+		auto sample(std::span<double const> const weights,
+		            std::span<double const> const block_sums,
+		            std::mt19937_64& engine) -> std::size_t {
+			auto const total = std::accumulate(block_sums.begin(), block_sums.end(), 0.0);
+			if (not(total > 0.0) or not std::isfinite(total)) {
+				return uniform_index(engine, weights.size());
+			}
+
+			auto remaining = uniform(engine) * total;
+			auto block = std::size_t{0};
+			for (auto b = std::size_t{0}; b < block_sums.size(); ++b) {
+				if (block_sums[b] <= 0.0) {
+					continue;
+				}
+				block = b;
+				if (remaining < block_sums[b]) {
+					break;
+				}
+				remaining -= block_sums[b];
+			}
+
+			// rounding can leave `remaining` past the end of the last block with any weight: then
+			// its last point with a weight is taken
+			auto const begin = block * seeding_block;
+			auto const block_weights = weights.subspan(begin, std::min(seeding_block, weights.size() - begin));
+			auto chosen = std::size_t{0};
+			for (auto i = std::size_t{0}; i < block_weights.size(); ++i) {
+				if (block_weights[i] > 0.0) {
+					chosen = i;
+					if (remaining < block_weights[i]) {
+						break;
+					}
+					remaining -= block_weights[i];
+				}
+			}
+			return begin + chosen;
+		}
+
+		// k-means++ (Arthur and Vassilvitskii, 2007): the first centroid is a uniformly random
+		// point, and each one after it is a point picked with probability proportional to its
+		// squared distance from the nearest centroid so far
+		auto seed_centroids(euclidean_matrix const& points,
+		                    int const clusters,
+		                    std::size_t const threads,
+		                    std::mt19937_64& engine) -> euclidean_matrix {
+			auto const rows = gsl_lite::narrow_cast<std::size_t>(points.rows());
+			auto centroids = euclidean_matrix(clusters, points.columns());
+			auto const use_point = [&](int const cluster, std::size_t const i) {
+				ranges::copy(point(points, i), centroids.row(cluster).begin());
+			};
+			use_point(0, uniform_index(engine, rows));
+
+			// squared distance from each point to its nearest centroid so far; only the newest
+			// centroid needs checking each round
+			auto distances = std::vector<double>(rows, std::numeric_limits<double>::infinity());
+			auto block_sums = std::vector<double>((rows + seeding_block - 1) / seeding_block);
+			for (auto cluster = 1; cluster < clusters; ++cluster) {
+				auto const newest = std::as_const(centroids).row(cluster - 1);
+				detail::parallel_for(
+				   block_sums.size(),
+				   threads,
+				   [&](std::size_t, std::size_t const block_begin, std::size_t const block_end) {
+					   for (auto b = block_begin; b < block_end; ++b) {
+						   auto sum = 0.0;
+						   for (auto i = b * seeding_block; i < std::min(rows, (b + 1) * seeding_block); ++i) {
+							   distances[i] = std::min(distances[i],
+							                           detail::squared_distance(point(points, i), newest));
+							   sum += distances[i];
+						   }
+						   block_sums[b] = sum;
+					   }
+				   });
+				use_point(cluster, sample(distances, block_sums, engine));
+			}
+			return centroids;
+		}
+
+		// assigns every point to its nearest centroid; returns the inertia
+		auto assign(euclidean_matrix const& points,
+		            euclidean_matrix const& centroids,
+		            std::span<int> const assignments,
+		            std::size_t const threads) -> double {
+			auto const rows = assignments.size();
+			auto inertia = std::vector<double>(std::min(threads, rows));
+			detail::parallel_for(rows,
+			                     threads,
+			                     [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+				                     for (auto i = begin; i < end; ++i) {
+					                     auto const [cluster, distance] = nearest(centroids, point(points, i));
+					                     assignments[i] = cluster;
+					                     inertia[chunk] += distance;
+				                     }
+			                     });
+			return std::accumulate(inertia.begin(), inertia.end(), 0.0);
+		}
+
+		// Points for reseeding `count` empty clusters: the ones furthest from their centroids,
+		// furthest first. Empty clusters are rare, so this is a plain serial pass
+		auto furthest_points(euclidean_matrix const& points,
+		                     euclidean_matrix const& centroids,
+		                     std::span<int const> const assignments,
+		                     std::size_t const count) -> std::vector<std::size_t> {
+			struct candidate {
+				double distance;
+				std::size_t index;
+			};
+			auto const further = [](candidate const& a, candidate const& b) {
+				return a.distance > b.distance;
+			};
+			// min-heap (on distance) of the furthest points seen so far
+			auto heap = std::vector<candidate>();
+			for (auto i = std::size_t{0}; i < assignments.size(); ++i) {
+				auto const distance =
+				   detail::squared_distance(point(points, i), centroids.row(assignments[i]));
+				if (heap.size() < count) {
+					heap.push_back({distance, i});
+					ranges::push_heap(heap, further);
+				}
+				else if (distance > heap.front().distance) {
+					ranges::pop_heap(heap, further);
+					heap.back() = {distance, i};
+					ranges::push_heap(heap, further);
+				}
+			}
+			ranges::sort_heap(heap, further);
+			auto result = std::vector<std::size_t>();
+			ranges::transform(heap, std::back_inserter(result), &candidate::index);
+			return result;
+		}
+
+		// what one thread gathers during a Lloyd assignment pass
+		struct lloyd_partial {
+			euclidean_matrix sums; // per cluster, of the points assigned to it
+			std::vector<std::size_t> counts;
+			double inertia;
+			std::size_t changed; // points that moved to another cluster
+		};
+
+		auto lloyd(euclidean_matrix const& points,
+		           kmeans_options const& options,
+		           std::size_t const threads,
+		           kmeans_result& result) -> void {
+			auto const rows = result.assignments.size();
+			auto const clusters = options.clusters;
+			auto& centroids = result.centroids;
+
+			// one set of sums per thread, so the assignment pass can accumulate them as it goes
+			// without any locking; they are merged in order afterwards
+			auto const chunks = std::min(threads, rows);
+			auto partials = std::vector<lloyd_partial>();
+			partials.reserve(chunks);
+			for (auto chunk = std::size_t{0}; chunk < chunks; ++chunk) {
+				partials.push_back({euclidean_matrix(clusters, points.columns()),
+				                    std::vector<std::size_t>(gsl_lite::narrow_cast<std::size_t>(clusters)),
+				                    0.0,
+				                    0});
+			}
+
+			auto stable = false; // no point changed cluster, so result.inertia is already current
+			while (result.iterations < options.max_iterations) {
+				detail::parallel_for(
+				   rows,
+				   chunks,
+				   [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+					   auto& partial = partials[chunk];
+					   for (auto c = 0; c < clusters; ++c) {
+						   ranges::fill(partial.sums.row(c), 0.0);
+					   }
+					   ranges::fill(partial.counts, std::size_t{0});
+					   partial.inertia = 0.0;
+					   partial.changed = 0;
+
+					   for (auto i = begin; i < end; ++i) {
+						   auto const x = point(points, i);
+						   auto const [cluster, distance] = nearest(centroids, x);
+						   if (result.assignments[i] != cluster) {
+							   result.assignments[i] = cluster;
+							   ++partial.changed;
+						   }
+						   partial.inertia += distance;
+						   ++partial.counts[gsl_lite::narrow_cast<std::size_t>(cluster)];
+						   auto const sum = partial.sums.row(cluster);
+						   ranges::transform(sum, x, sum.begin(), std::plus<>());
+					   }
+				   });
+				++result.iterations;
+
+				auto& total = partials.front();
+				for (auto const& partial : std::span(partials).subspan(1)) {
+					for (auto c = 0; c < clusters; ++c) {
+						auto const sum = total.sums.row(c);
+						ranges::transform(sum, std::as_const(partial.sums).row(c), sum.begin(), std::plus<>());
+					}
+					ranges::transform(total.counts, partial.counts, total.counts.begin(), std::plus<>());
+					total.inertia += partial.inertia;
+					total.changed += partial.changed;
+				}
+				result.inertia = total.inertia;
+				if (total.changed == 0) { // the centroids are already the means of their clusters
+					result.converged = stable = true;
+					break;
+				}
+
+				// update step: each centroid moves to the mean of its points
+				auto largest_shift = 0.0; // squared
+				auto empty = std::vector<int>();
+				for (auto c = 0; c < clusters; ++c) {
+					auto const count = total.counts[gsl_lite::narrow_cast<std::size_t>(c)];
+					if (count == 0) {
+						empty.push_back(c);
+						continue;
+					}
+					auto const centroid = centroids.row(c);
+					auto shift = 0.0;
+					ranges::transform(std::as_const(total.sums).row(c),
+					                  centroid,
+					                  centroid.begin(),
+					                  [n = static_cast<double>(count), &shift](double const sum, double const old) {
+						                  auto const mean = sum / n;
+						                  shift += (mean - old) * (mean - old);
+						                  return mean;
+					                  });
+					largest_shift = std::max(largest_shift, shift);
+				}
+				if (not empty.empty()) {
+					// measured against the centroids the points were just assigned to, but that
+					// is close enough for choosing which points are poorly served
+					auto const reseeds = furthest_points(points, centroids, result.assignments, empty.size());
+					for (auto j = std::size_t{0}; j < reseeds.size(); ++j) {
+						ranges::copy(point(points, reseeds[j]), centroids.row(empty[j]).begin());
+					}
+					largest_shift = std::numeric_limits<double>::infinity(); // not converged
+				}
+				if (std::sqrt(largest_shift) <= options.tolerance) {
+					result.converged = true;
+					break;
+				}
+			}
+
+			if (not stable) { // the centroids moved after the last assignment pass
+				result.inertia = assign(points, centroids, result.assignments, threads);
+			}
+		}
+
+		// Mini-batch iterations: each one assigns a random sample of points (in parallel) and
+		// moves each centroid towards its sampled points with a per-centroid learning rate of
+		// 1 / (points it has absorbed so far), which averages them out as the counts grow
+		auto mini_batch(euclidean_matrix const& points,
+		                kmeans_options const& options,
+		                std::size_t const threads,
+		                std::mt19937_64& engine,
+		                kmeans_result& result) -> void {
+			auto const rows = result.assignments.size();
+			auto const clusters = options.clusters;
+			auto& centroids = result.centroids;
+
+			// all allocated once, up front
+			auto batch = std::vector<std::size_t>(options.batch_size);
+			auto batch_clusters = std::vector<int>(options.batch_size);
+			auto absorbed = std::vector<std::size_t>(gsl_lite::narrow_cast<std::size_t>(clusters));
+			auto previous = euclidean_matrix(clusters, points.columns());
+
+			while (result.iterations < options.max_iterations) {
+				ranges::generate(batch, [&] { return uniform_index(engine, rows); });
+				detail::parallel_for(batch.size(),
+				                     threads,
+				                     [&](std::size_t, std::size_t const begin, std::size_t const end) {
+					                     for (auto j = begin; j < end; ++j) {
+						                     batch_clusters[j] = nearest(centroids, point(points, batch[j])).cluster;
+					                     }
+				                     });
+
+				for (auto c = 0; c < clusters; ++c) {
+					ranges::copy(std::as_const(centroids).row(c), previous.row(c).begin());
+				}
+				// serial and in batch order: each update depends on the ones before it
+				for (auto j = std::size_t{0}; j < batch.size(); ++j) {
+					auto const cluster = batch_clusters[j];
+					auto const rate =
+					   1.0 / static_cast<double>(++absorbed[gsl_lite::narrow_cast<std::size_t>(cluster)]);
+					auto const centroid = centroids.row(cluster);
+					ranges::transform(centroid, point(points, batch[j]), centroid.begin(), [rate](double const c, double const x) {
+						return c + rate * (x - c);
+					});
+				}
+				++result.iterations;
+
+				auto largest_shift = 0.0;
+				for (auto c = 0; c < clusters; ++c) {
+					largest_shift = std::max(
+					   largest_shift,
+					   detail::squared_distance(std::as_const(centroids).row(c), std::as_const(previous).row(c)));
+				}
+				if (std::sqrt(largest_shift) <= options.tolerance) {
+					result.converged = true;
+					break;
+				}
+			}
+
+			result.inertia = assign(points, centroids, result.assignments, threads);
+		}
+	} // namespace
+
+	auto kmeans(euclidean_matrix const& points, kmeans_options const& options) -> kmeans_result {
+		check_options(points, options);
+		auto const threads = detail::thread_count(options.threads);
+		auto engine = std::mt19937_64(options.seed);
+
+		auto result = kmeans_result{seed_centroids(points, options.clusters, threads, engine),
+		                            std::vector<int>(gsl_lite::narrow_cast<std::size_t>(points.rows()), -1),
+		                            0.0,
+		                            0,
+		                            false};
+		if (options.batch_size == 0) {
+			lloyd(points, options, threads, result);
+		}
+		else {
+			mini_batch(points, options, threads, engine, result);
+		}
+		return result;
+	}
+
+	auto kmeans(std::span<euclidean_vector const> const points, kmeans_options const& options)
+	   -> kmeans_result {
+		return kmeans(euclidean_matrix(points), options);
+	}
+
+} // namespace comp6771
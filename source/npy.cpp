@@ -0,0 +1,426 @@
+// NumPy .npy reading (memory-mapped) and writing.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "npy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <gsl/gsl-lite.hpp>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+
+	// the views are the file's bytes as they are, and the writers copy the storage's bytes out
+	static_assert(std::endian::native == std::endian::little, ".npy support assumes a little-endian host");
+
+	namespace {
+		constexpr auto magic = std::string_view("\x93NUMPY", 6);
+		// numpy pads the header so the data starts on a 64-byte boundary (and so do we)
+		constexpr auto header_alignment = std::size_t{64};
+		constexpr auto version_1_preamble = std::size_t{10}; // magic, version, 2-byte length
+		constexpr auto version_2_preamble = std::size_t{12}; // magic, version, 4-byte length
+
+		auto file_error(std::string const& path, std::string const& what) -> euclidean_vector_error {
+			return euclidean_vector_error(path + ": " + what);
+		}
+
+		auto element_size(npy_dtype const dtype) noexcept -> std::size_t {
+			return dtype == npy_dtype::float64 ? sizeof(double) : sizeof(float);
+		}
+
+		// The value of `key` in the header, which is a Python dict literal such as
+		//    {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+		// Returned as written: a quoted string with its quotes, a tuple with its parentheses
+		auto dict_value(std::string_view const header, std::string_view const key)
+		   -> std::optional<std::string_view> {
+			auto position = std::string_view::npos;
+			for (auto const quote : {'\'', '"'}) {
+				auto const quoted = std::string(1, quote) + std::string(key) + quote;
+				position = header.find(quoted);
+				if (position != std::string_view::npos) {
+					position += quoted.size();
+					break;
+				}
+			}
+			if (position == std::string_view::npos) {
+				return std::nullopt;
+			}
+			position = header.find_first_not_of(" :", position);
+			if (position == std::string_view::npos) {
+				return std::nullopt;
+			}
+
+			auto const opening = header[position];
+			auto const closing = opening == '(' ? ')' : opening == '\'' or opening == '"' ? opening : '\0';
+			auto const end = closing == '\0' ? header.find_first_of(",}", position)
+			                                 : header.find(closing, position + 1);
+			if (end == std::string_view::npos) {
+				return std::nullopt;
+			}
+			auto value = header.substr(position, end - position + (closing == '\0' ? 0 : 1));
+			while (not value.empty() and value.back() == ' ') {
+				value.remove_suffix(1);
+			}
+			return value;
+		}
+
+		// "(3, 4)", "(3,)" or "()" into its dimensions
+		auto parse_shape(std::string_view shape) -> std::optional<std::vector<std::size_t>> {
+			if (shape.size() < 2 or shape.front() != '(' or shape.back() != ')') {
+				return std::nullopt;
+			}
+			shape = shape.substr(1, shape.size() - 2);
+			auto result = std::vector<std::size_t>();
+			while (true) {
+				auto const start = shape.find_first_not_of(' ');
+				if (start == std::string_view::npos) {
+					break; // nothing left, or only the trailing comma of a 1-tuple before this
+				}
+				shape.remove_prefix(start);
+				auto dimension = std::size_t{0};
+				auto const [rest, error] = std::from_chars(shape.data(), shape.data() + shape.size(), dimension);
+				if (error != std::errc()) {
+					return std::nullopt;
+				}
+				result.push_back(dimension);
+				shape.remove_prefix(gsl_lite::narrow_cast<std::size_t>(rest - shape.data()));
+				shape.remove_prefix(std::min(shape.find_first_not_of(' '), shape.size()));
+				if (shape.empty()) {
+					break;
+				}
+				if (shape.front() != ',') {
+					return std::nullopt;
+				}
+				shape.remove_prefix(1);
+			}
+			return result;
+		}
+
+		auto read_little_endian(std::span<std::byte const> const bytes) noexcept -> std::size_t {
+			auto result = std::size_t{0};
+			for (auto i = bytes.size(); i > 0; --i) {
+				result = (result << 8) | std::to_integer<std::size_t>(bytes[i - 1]);
+			}
+			return result;
+		}
+
+		struct npy_header {
+			npy_dtype dtype;
+			int rank;
+			std::size_t rows;
+			std::size_t columns;
+			std::size_t data_offset;
+		};
+
+		auto parse_header(std::span<std::byte const> const file, std::string const& path) -> npy_header {
+			if (file.size() < version_1_preamble
+			    or std::string_view(reinterpret_cast<char const*>(file.data()), magic.size()) != magic) {
+				throw file_error(path, "not a .npy file");
+			}
+			auto const major_version = std::to_integer<int>(file[6]);
+			if (major_version < 1 or major_version > 3) {
+				throw file_error(path, "unsupported .npy format version " + std::to_string(major_version));
+			}
+			auto const preamble = major_version == 1 ? version_1_preamble : version_2_preamble;
+			if (file.size() < preamble) {
+				throw file_error(path, "file is shorter than its header");
+			}
+			auto const header_size = read_little_endian(file.subspan(8, preamble - 8));
+			if (file.size() - preamble < header_size) {
+				throw file_error(path, "file is shorter than its header");
+			}
+			auto const header =
+			   std::string_view(reinterpret_cast<char const*>(file.data() + preamble), header_size);
+
+			auto const descr = dict_value(header, "descr");
+			auto const fortran_order = dict_value(header, "fortran_order");
+			auto const shape_text = dict_value(header, "shape");
+			if (not descr or not fortran_order or not shape_text) {
+				throw file_error(path, "header is missing descr, fortran_order or shape");
+			}
+			auto result = npy_header{npy_dtype::float64, 1, 1, 0, preamble + header_size};
+			if (*descr == "'<f8'" or *descr == "\"<f8\"") {
+				result.dtype = npy_dtype::float64;
+			}
+			else if (*descr == "'<f4'" or *descr == "\"<f4\"") {
+				result.dtype = npy_dtype::float32;
+			}
+			else {
+				throw file_error(path, "unsupported dtype " + std::string(*descr)
+				                          + " (only little-endian float64 and float32 are)");
+			}
+			if (*fortran_order != "False") {
+				throw file_error(path, "only C-order arrays are supported");
+			}
+
+			auto const shape = parse_shape(*shape_text);
+			if (not shape) {
+				throw file_error(path, "cannot read shape " + std::string(*shape_text));
+			}
+			if (shape->size() == 1) {
+				result.columns = (*shape)[0];
+			}
+			else if (shape->size() == 2) {
+				result.rank = 2;
+				result.rows = (*shape)[0];
+				result.columns = (*shape)[1];
+			}
+			else {
+				throw file_error(path, "only 1-D and 2-D arrays are supported, not "
+				                          + std::to_string(shape->size()) + "-D");
+			}
+
+			constexpr auto int_max = static_cast<std::size_t>(std::numeric_limits<int>::max());
+			if (result.rows > int_max or result.columns > int_max) {
+				throw file_error(path, "array is too large");
+			}
+			auto const element = element_size(result.dtype);
+			auto const available = (file.size() - result.data_offset) / element;
+			if (result.columns != 0 and result.rows > available / result.columns) {
+				throw file_error(path, "file is shorter than its array");
+			}
+			// the mapping starts on a page, so this makes every value correctly aligned
+			if (result.data_offset % element != 0) {
+				throw file_error(path, "array data is not aligned");
+			}
+			return result;
+		}
+
+		auto dtype_descr(npy_dtype const dtype) -> std::string_view {
+			return dtype == npy_dtype::float64 ? "<f8" : "<f4";
+		}
+
+		// Header with a given shape, padded with spaces and a newline so the data starts on a
+		// header_alignment boundary. Version 1.0 unless the header is too long for its 2-byte length
+		auto write_header(std::ostream& os, npy_dtype const dtype, std::string const& shape) -> void {
+			auto header = "{'descr': '" + std::string(dtype_descr(dtype)) + "', 'fortran_order': False, 'shape': "
+			              + shape + ", }";
+			auto preamble = version_1_preamble;
+			auto const padded_size = [&] {
+				auto const total = preamble + header.size() + 1; // + 1 for the newline
+				return (total + header_alignment - 1) / header_alignment * header_alignment - preamble;
+			};
+			if (padded_size() > std::numeric_limits<std::uint16_t>::max()) {
+				preamble = version_2_preamble;
+			}
+			auto const header_size = padded_size();
+			header.resize(header_size - 1, ' ');
+			header.push_back('\n');
+
+			os.write(magic.data(), gsl_lite::narrow_cast<std::streamsize>(magic.size()));
+			os.put(preamble == version_1_preamble ? '\x01' : '\x02');
+			os.put('\x00');
+			for (auto i = std::size_t{0}; i < preamble - 8; ++i) {
+				os.put(static_cast<char>((header_size >> (8 * i)) & 0xff));
+			}
+			os.write(header.data(), gsl_lite::narrow_cast<std::streamsize>(header.size()));
+		}
+
+		// float64 goes out straight from the storage; float32 is converted a block at a time
+		auto write_values(std::ostream& os, std::span<double const> const values, npy_dtype const dtype)
+		   -> void {
+			if (dtype == npy_dtype::float64) {
+				os.write(reinterpret_cast<char const*>(values.data()),
+				         gsl_lite::narrow_cast<std::streamsize>(values.size_bytes()));
+				return;
+			}
+			auto buffer = std::array<float, 1024>();
+			for (auto begin = std::size_t{0}; begin < values.size(); begin += buffer.size()) {
+				auto const block = values.subspan(begin, std::min(buffer.size(), values.size() - begin));
+				ranges::transform(block, buffer.begin(), [](double const x) { return static_cast<float>(x); });
+				os.write(reinterpret_cast<char const*>(buffer.data()),
+				         gsl_lite::narrow_cast<std::streamsize>(block.size() * sizeof(float)));
+			}
+		}
+
+		auto check_stream(std::ostream const& os) -> void {
+			if (not os) {
+				throw euclidean_vector_error("Could not write .npy data");
+			}
+		}
+	} // namespace
+
+	// reading
+
+	npy_file::npy_file(std::string const& path) {
+		auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw file_error(path, "could not open file");
+		}
+		struct ::stat status {};
+		if (::fstat(fd, &status) != 0 or status.st_size <= 0) {
+			::close(fd);
+			throw file_error(path, "not a .npy file");
+		}
+		mapping_size_ = gsl_lite::narrow_cast<std::size_t>(status.st_size);
+		auto* const mapping = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // the mapping keeps the file open
+		if (mapping == MAP_FAILED) {
+			throw file_error(path, "could not map file");
+		}
+		mapping_ = mapping;
+
+		try {
+			auto const file = std::span<std::byte const>(static_cast<std::byte const*>(mapping_), mapping_size_);
+			auto const header = parse_header(file, path);
+			data_ = file.data() + header.data_offset;
+			dtype_ = header.dtype;
+			rank_ = header.rank;
+			rows_ = header.rows;
+			columns_ = header.columns;
+		} catch (...) {
+			unmap();
+			throw;
+		}
+	}
+
+	npy_file::npy_file(npy_file&& other) noexcept
+	: mapping_(std::exchange(other.mapping_, nullptr))
+	, mapping_size_(std::exchange(other.mapping_size_, 0))
+	, data_(std::exchange(other.data_, nullptr))
+	, dtype_(other.dtype_)
+	, rank_(other.rank_)
+	, rows_(std::exchange(other.rows_, 0))
+	, columns_(std::exchange(other.columns_, 0)) {}
+
+	npy_file::~npy_file() noexcept {
+		unmap();
+	}
+
+	auto npy_file::operator=(npy_file&& other) noexcept -> npy_file& {
+		if (this != &other) {
+			unmap();
+			mapping_ = std::exchange(other.mapping_, nullptr);
+			mapping_size_ = std::exchange(other.mapping_size_, 0);
+			data_ = std::exchange(other.data_, nullptr);
+			dtype_ = other.dtype_;
+			rank_ = other.rank_;
+			rows_ = std::exchange(other.rows_, 0);
+			columns_ = std::exchange(other.columns_, 0);
+		}
+		return *this;
+	}
+
+	auto npy_file::unmap() noexcept -> void {
+		if (mapping_ != nullptr) {
+			::munmap(mapping_, mapping_size_);
+			mapping_ = nullptr;
+		}
+	}
+
+	auto npy_file::dtype() const noexcept -> npy_dtype {
+		return dtype_;
+	}
+
+	auto npy_file::rank() const noexcept -> int {
+		return rank_;
+	}
+
+	auto npy_file::rows() const noexcept -> int {
+		return gsl_lite::narrow_cast<int>(rows_);
+	}
+
+	auto npy_file::columns() const noexcept -> int {
+		return gsl_lite::narrow_cast<int>(columns_);
+	}
+
+	auto npy_file::values() const -> std::span<double const> {
+		if (dtype_ != npy_dtype::float64) {
+			throw euclidean_vector_error("npy_file holds float32 values, not float64");
+		}
+		return std::span<double const>(reinterpret_cast<double const*>(data_), rows_ * columns_);
+	}
+
+	auto npy_file::row(int const row) const -> std::span<double const> {
+		assert(row >= 0 and gsl_lite::narrow_cast<std::size_t>(row) < rows_);
+		return values().subspan(gsl_lite::narrow_cast<std::size_t>(row) * columns_, columns_);
+	}
+
+	auto npy_file::float_values() const -> std::span<float const> {
+		if (dtype_ != npy_dtype::float32) {
+			throw euclidean_vector_error("npy_file holds float64 values, not float32");
+		}
+		return std::span<float const>(reinterpret_cast<float const*>(data_), rows_ * columns_);
+	}
+
+	auto npy_file::row_vector(int const row_index) const -> euclidean_vector {
+		if (dtype_ == npy_dtype::float64) {
+			return euclidean_vector(row(row_index));
+		}
+		assert(row_index >= 0 and gsl_lite::narrow_cast<std::size_t>(row_index) < rows_);
+		return euclidean_vector(
+		   float_values().subspan(gsl_lite::narrow_cast<std::size_t>(row_index) * columns_, columns_));
+	}
+
+	auto npy_file::to_vectors() const -> std::vector<euclidean_vector> {
+		auto result = std::vector<euclidean_vector>();
+		result.reserve(rows_);
+		for (auto r = 0; r < rows(); ++r) {
+			result.push_back(row_vector(r));
+		}
+		return result;
+	}
+
+	auto npy_file::to_matrix() const -> euclidean_matrix {
+		auto result = euclidean_matrix(rows(), columns());
+		for (auto r = 0; r < rows(); ++r) {
+			auto const offset = gsl_lite::narrow_cast<std::size_t>(r) * columns_;
+			if (dtype_ == npy_dtype::float64) {
+				ranges::copy(values().subspan(offset, columns_), result.row(r).begin());
+			}
+			else {
+				ranges::copy(float_values().subspan(offset, columns_), result.row(r).begin());
+			}
+		}
+		return result;
+	}
+
+	// writing
+
+	auto write_npy(std::ostream& os, euclidean_vector const& v, npy_dtype const dtype) -> void {
+		write_header(os, dtype, "(" + std::to_string(v.dimensions()) + ",)");
+		write_values(os, std::span<double const>(v.data(), v.size()), dtype);
+		check_stream(os);
+	}
+
+	auto write_npy(std::ostream& os, std::span<euclidean_vector const> const vectors, npy_dtype const dtype)
+	   -> void {
+		auto const columns = vectors.empty() ? 0 : vectors.front().dimensions();
+		// checked before anything is written, so a mismatch doesn't leave half a file
+		for (auto const& v : vectors) {
+			if (v.dimensions() != columns) {
+				throw euclidean_vector_error("Dimensions of npy rows (" + std::to_string(columns) + " and "
+				                             + std::to_string(v.dimensions()) + ") do not match");
+			}
+		}
+		write_header(os, dtype, "(" + std::to_string(vectors.size()) + ", " + std::to_string(columns) + ")");
+		for (auto const& v : vectors) {
+			write_values(os, std::span<double const>(v.data(), v.size()), dtype);
+		}
+		check_stream(os);
+	}
+
+	auto write_npy(std::ostream& os, euclidean_matrix const& m, npy_dtype const dtype) -> void {
+		write_header(os, dtype, "(" + std::to_string(m.rows()) + ", " + std::to_string(m.columns()) + ")");
+		for (auto r = 0; r < m.rows(); ++r) {
+			write_values(os, m.row(r), dtype); // without the padding
+		}
+		check_stream(os);
+	}
+
+} // namespace comp6771
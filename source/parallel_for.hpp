@@ -0,0 +1,45 @@
+#ifndef COMP6771_PARALLEL_FOR_HPP
+#define COMP6771_PARALLEL_FOR_HPP
+
+// Internal helper shared by the multi-threaded kernels in this directory. Not part of the public
+// interface, so it lives next to the sources rather than in include/.
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace comp6771::detail {
+	// number of threads to use when the caller asks for `requested` (anything below 1 means "as
+	// many as the hardware has")
+	inline auto thread_count(int const requested) noexcept -> std::size_t {
+		if (requested > 0) {
+			return static_cast<std::size_t>(requested);
+		}
+		return std::max(std::size_t{1}, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+	}
+
+	// Splits [0, count) into at most `threads` contiguous, near-equal chunks and calls
+	// chunk_fn(chunk_index, begin, end) for each. The calling thread runs the first chunk, so one
+	// thread (or a small count) costs no thread start-up at all. chunk_fn must not throw.
+	template<typename ChunkFn>
+	auto parallel_for(std::size_t const count, std::size_t const threads, ChunkFn const& chunk_fn)
+	   -> void {
+		auto const chunks = std::max(std::size_t{1}, std::min(threads, count));
+		auto const chunk_size = count / chunks;
+		auto const remainder = count % chunks;
+		auto const chunk_begin = [&](std::size_t const chunk) {
+			return chunk * chunk_size + std::min(chunk, remainder);
+		};
+
+		auto workers = std::vector<std::jthread>();
+		workers.reserve(chunks - 1);
+		for (auto chunk = std::size_t{1}; chunk < chunks; ++chunk) {
+			workers.emplace_back(chunk_fn, chunk, chunk_begin(chunk), chunk_begin(chunk + 1));
+		}
+		chunk_fn(std::size_t{0}, chunk_begin(0), chunk_begin(1));
+		// jthreads join on destruction
+	}
+} // namespace comp6771::detail
+
+#endif // COMP6771_PARALLEL_FOR_HPP
@@ -0,0 +1,198 @@
+// int8 scalar quantisation of euclidean_vectors, with approximate dot products and distances.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "quantised_vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <gsl/gsl-lite.hpp>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+
+	namespace {
+		constexpr auto max_code = 127; // codes are symmetric, [-127, 127], so -128 is never used
+
+		// products of two codes are at most 127 * 127, so this many of them can be summed in an
+		// int32 without overflowing. Integer sums are exact in any order, which leaves the
+		// compiler free to vectorise them (widening int8 multiplies into int32 lanes)
+		constexpr auto int32_block = std::size_t{65536};
+
+		auto code_dot(std::span<std::int8_t const> const a, std::span<std::int8_t const> const b)
+		   -> std::int64_t {
+			auto total = std::int64_t{0};
+			for (auto block = std::size_t{0}; block < a.size(); block += int32_block) {
+				auto const width = std::min(int32_block, a.size() - block);
+				auto const a_block = a.subspan(block, width);
+				total += std::transform_reduce(a_block.begin(),
+				                               a_block.end(),
+				                               b.subspan(block, width).begin(),
+				                               std::int32_t{0},
+				                               std::plus<>(),
+				                               [](std::int8_t const x, std::int8_t const y) {
+					                               return std::int32_t{x} * std::int32_t{y};
+				                               });
+			}
+			return total;
+		}
+
+		auto check_dimensions(quantised_vector const& lhs, quantised_vector const& rhs) -> void {
+			if (lhs.dimensions() != rhs.dimensions()) {
+				auto except_string = "Dimensions of LHS(" + std::to_string(lhs.dimensions())
+				                     + ") and RHS(" + std::to_string(rhs.dimensions())
+				                     + ") do not match";
+				throw euclidean_vector_error(except_string);
+			}
+		}
+	} // namespace
+
+	// encoding: offset is the midpoint of the vector's range and scale maps the range onto the 255
+	// codes, so the largest and smallest magnitudes are represented (almost) exactly
+	quantised_vector::quantised_vector(euclidean_vector const& ev)
+	: dimensions_(ev.dimensions_)
+	, scale_(0.0)
+	, offset_(0.0)
+	, code_sum_(0)
+	, squared_norm_(0.0) {
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		codes_ = std::make_unique<std::int8_t[]>(dimensions_);
+		if (dimensions_ == 0) {
+			return;
+		}
+
+		auto const magnitude_span = std::span<double const>(ev.magnitudes_.get(), ev.dimensions_);
+		auto const code_span = std::span<std::int8_t>(codes_.get(), dimensions_);
+		auto const [min, max] = ranges::minmax(magnitude_span);
+		offset_ = min / 2 + max / 2; // halving first, so huge magnitudes can't overflow
+		scale_ = (max / 2 - min / 2) / max_code;
+
+		if (scale_ > 0) {
+			ranges::transform(magnitude_span, code_span.begin(), [this](double const x) {
+				auto const code = std::clamp(std::lround((x - offset_) / scale_),
+				                             long{-max_code},
+				                             long{max_code});
+				return gsl_lite::narrow_cast<std::int8_t>(code);
+			});
+		}
+		// else every magnitude is the same, and the codes stay 0 (decoding to offset_)
+
+		code_sum_ = std::transform_reduce(code_span.begin(),
+		                                  code_span.end(),
+		                                  std::int64_t{0},
+		                                  std::plus<>(),
+		                                  [](std::int8_t const q) { return std::int64_t{q}; });
+		// norm of what decode() gives back, not of the original, so distances are consistent
+		squared_norm_ = std::transform_reduce(code_span.begin(),
+		                                      code_span.end(),
+		                                      0.0,
+		                                      std::plus<>(),
+		                                      [this](std::int8_t const q) {
+			                                      auto const x = offset_ + scale_ * q;
+			                                      return x * x;
+		                                      });
+	}
+
+	quantised_vector::quantised_vector(quantised_vector const& other)
+	: dimensions_(other.dimensions_)
+	, scale_(other.scale_)
+	, offset_(other.offset_)
+	, code_sum_(other.code_sum_)
+	, squared_norm_(other.squared_norm_) {
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		codes_ = std::make_unique_for_overwrite<std::int8_t[]>(dimensions_);
+		ranges::copy(other.codes(), codes_.get());
+	}
+
+	quantised_vector::quantised_vector(quantised_vector&& other) noexcept
+	: codes_(std::move(other.codes_))
+	, dimensions_(std::exchange(other.dimensions_, 0))
+	, scale_(other.scale_)
+	, offset_(other.offset_)
+	, code_sum_(other.code_sum_)
+	, squared_norm_(other.squared_norm_) {}
+
+	auto quantised_vector::operator=(quantised_vector const& other) -> quantised_vector& {
+		if (this != &other) {
+			*this = quantised_vector(other);
+		}
+		return *this;
+	}
+
+	auto quantised_vector::operator=(quantised_vector&& other) noexcept -> quantised_vector& {
+		codes_ = std::move(other.codes_);
+		dimensions_ = std::exchange(other.dimensions_, 0);
+		scale_ = other.scale_;
+		offset_ = other.offset_;
+		code_sum_ = other.code_sum_;
+		squared_norm_ = other.squared_norm_;
+		return *this;
+	}
+
+	auto quantised_vector::decode() const -> euclidean_vector {
+		auto result = euclidean_vector(gsl_lite::narrow_cast<int>(dimensions_));
+		ranges::transform(codes(),
+		                  result.magnitudes_.get(),
+		                  [this](std::int8_t const q) { return offset_ + scale_ * q; });
+		return result;
+	}
+
+	auto quantised_vector::dimensions() const noexcept -> int {
+		return gsl_lite::narrow_cast<int>(dimensions_);
+	}
+
+	auto quantised_vector::scale() const noexcept -> double {
+		return scale_;
+	}
+
+	auto quantised_vector::offset() const noexcept -> double {
+		return offset_;
+	}
+
+	auto quantised_vector::codes() const noexcept -> std::span<std::int8_t const> {
+		return std::span<std::int8_t const>(codes_.get(), dimensions_);
+	}
+
+	// with a = oa + sa * qa and b = ob + sb * qb (element-wise),
+	//   a.b = n*oa*ob + oa*sb*sum(qb) + ob*sa*sum(qa) + sa*sb*(qa.qb)
+	// so the only per-element work is the integer dot product qa.qb
+	auto approximate_dot(quantised_vector const& a, quantised_vector const& b) -> double {
+		check_dimensions(a, b);
+		auto const n = static_cast<double>(a.dimensions_);
+		auto const codes_dot = static_cast<double>(code_dot(a.codes(), b.codes()));
+		return n * a.offset_ * b.offset_ + a.offset_ * b.scale_ * static_cast<double>(b.code_sum_)
+		       + b.offset_ * a.scale_ * static_cast<double>(a.code_sum_)
+		       + a.scale_ * b.scale_ * codes_dot;
+	}
+
+	// |a - b|^2 = |a|^2 + |b|^2 - 2 a.b, using the squared norms stored at encode time
+	auto approximate_distance(quantised_vector const& a, quantised_vector const& b) -> double {
+		auto const squared = a.squared_norm_ + b.squared_norm_ - 2 * approximate_dot(a, b);
+		return std::sqrt(std::max(squared, 0.0)); // rounding can take it slightly below 0
+	}
+
+	auto rerank(euclidean_vector const& query,
+	            std::span<euclidean_vector const> const corpus,
+	            std::span<std::size_t const> const candidates,
+	            std::size_t const k) -> std::vector<scored_index> {
+		auto scored = std::vector<scored_index>();
+		scored.reserve(candidates.size());
+		ranges::transform(candidates, std::back_inserter(scored), [&](std::size_t const index) {
+			assert(index < corpus.size());
+			return scored_index{index, dot(corpus[index], query)};
+		});
+
+		auto const kept = std::min(k, scored.size());
+		auto const middle = scored.begin() + gsl_lite::narrow_cast<std::ptrdiff_t>(kept);
+		std::partial_sort(scored.begin(), middle, scored.end(), [](auto const& x, auto const& y) {
+			return x.score > y.score;
+		});
+		scored.erase(middle, scored.end());
+		return scored;
+	}
+
+} // namespace comp6771
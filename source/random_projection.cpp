@@ -0,0 +1,142 @@
+// Johnson-Lindenstrauss random projections (Gaussian and Achlioptas).
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "random_projection.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gsl/gsl-lite.hpp>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace comp6771 {
+
+	namespace {
+		// uniform in [0, 1), from the top 53 bits
+		auto uniform(std::mt19937_64& engine) -> double {
+			return static_cast<double>(engine() >> 11) * 0x1p-53;
+		}
+
+		// Box-Muller: two independent standard normal values per pair of uniforms
+		auto fill_gaussian(euclidean_matrix& m, std::mt19937_64& engine) -> void {
+			auto const scale = 1.0 / std::sqrt(static_cast<double>(m.rows()));
+			auto spare = 0.0;
+			auto has_spare = false;
+			for (auto r = 0; r < m.rows(); ++r) {
+				for (auto& entry : m.row(r)) {
+					if (has_spare) {
+						entry = scale * spare;
+						has_spare = false;
+						continue;
+					}
+					auto const radius = std::sqrt(-2.0 * std::log(1.0 - uniform(engine))); // log of (0, 1]
+					auto const angle = 2.0 * std::numbers::pi * uniform(engine);
+					entry = scale * radius * std::cos(angle);
+					spare = radius * std::sin(angle);
+					has_spare = true;
+				}
+			}
+		}
+
+		// Achlioptas: +1 and -1 with probability 1/6 each, 0 otherwise, times sqrt(3 / output)
+		auto fill_sparse(euclidean_matrix& m, std::mt19937_64& engine) -> void {
+			auto const scale = std::sqrt(3.0 / static_cast<double>(m.rows()));
+			for (auto r = 0; r < m.rows(); ++r) {
+				for (auto& entry : m.row(r)) {
+					switch (engine() % 6) { // bias from 2^64 not being a multiple of 6 is ~1e-19
+					case 0: entry = scale; break;
+					case 1: entry = -scale; break;
+					default: entry = 0.0; break;
+					}
+				}
+			}
+		}
+
+		auto checked_matrix(int const input_dimensions, int const output_dimensions) -> euclidean_matrix {
+			if (input_dimensions < 1 or output_dimensions < 1) {
+				throw euclidean_vector_error("Cannot project from " + std::to_string(input_dimensions)
+				                             + " to " + std::to_string(output_dimensions)
+				                             + " dimensions");
+			}
+			return euclidean_matrix(output_dimensions, input_dimensions);
+		}
+	} // namespace
+
+	random_projection::random_projection(int const input_dimensions,
+	                                     int const output_dimensions,
+	                                     projection_kind const kind,
+	                                     std::uint64_t const seed)
+	: kind_(kind)
+	, seed_(seed)
+	, matrix_(checked_matrix(input_dimensions, output_dimensions)) {
+		auto engine = std::mt19937_64(seed);
+		if (kind == projection_kind::gaussian) {
+			fill_gaussian(matrix_, engine);
+		}
+		else {
+			fill_sparse(matrix_, engine);
+		}
+	}
+
+	auto random_projection::input_dimensions() const noexcept -> int {
+		return matrix_.columns();
+	}
+
+	auto random_projection::output_dimensions() const noexcept -> int {
+		return matrix_.rows();
+	}
+
+	auto random_projection::kind() const noexcept -> projection_kind {
+		return kind_;
+	}
+
+	auto random_projection::seed() const noexcept -> std::uint64_t {
+		return seed_;
+	}
+
+	auto random_projection::matrix() const noexcept -> euclidean_matrix const& {
+		return matrix_;
+	}
+
+	auto random_projection::operator()(euclidean_vector const& v) const -> euclidean_vector {
+		return matrix_ * v;
+	}
+
+	// batch * transpose(matrix_): each projected row is the batch row dotted with every row of the
+	// projection, which is what multiply_transposed is tiled for
+	auto random_projection::operator()(euclidean_matrix const& batch, int const threads) const
+	   -> euclidean_matrix {
+		return multiply_transposed(batch, matrix_, threads);
+	}
+
+	auto random_projection::operator()(std::span<euclidean_vector const> const batch,
+	                                   int const threads) const -> std::vector<euclidean_vector> {
+		if (batch.empty()) {
+			return {};
+		}
+		auto const projected = (*this)(euclidean_matrix(batch), threads);
+		auto result = std::vector<euclidean_vector>();
+		result.reserve(batch.size());
+		for (auto r = 0; r < projected.rows(); ++r) {
+			result.push_back(projected.row_vector(r));
+		}
+		return result;
+	}
+
+	auto target_dimensions(std::size_t const points, double const epsilon) -> int {
+		if (not(epsilon > 0.0 and epsilon < 1.0)) {
+			throw euclidean_vector_error("epsilon must be between 0 and 1 exclusive");
+		}
+		if (points < 2) { // no distances to preserve
+			return 1;
+		}
+		auto const denominator = epsilon * epsilon / 2.0 - epsilon * epsilon * epsilon / 3.0;
+		auto const dimensions = std::ceil(4.0 * std::log(static_cast<double>(points)) / denominator);
+		return gsl_lite::narrow_cast<int>(dimensions);
+	}
+
+} // namespace comp6771
@@ -0,0 +1,288 @@
+// Welford running mean, variance and covariance, with batch updates and merging.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "running_statistics.hpp"
+
+#include "dot_kernel.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <gsl/gsl-lite.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace comp6771 {
+
+	namespace {
+		auto storage(euclidean_vector const& v) noexcept -> std::span<double const> {
+			return std::span<double const>(v.data(), v.size());
+		}
+
+		// Writable storage of the running sums. Non-const data() can allocate in general (it detaches
+		// copy-on-write storage), but these vectors never have share_on_copy on and so never share,
+		// which lets the updates stay noexcept
+		auto writable(euclidean_vector& v) noexcept -> std::span<double> {
+			assert(not v.shares_on_copy());
+			return std::span<double>(v.data(), v.size());
+		}
+
+		// squared_deviations[i] += weight * delta[i]^2, and the same outer product into the upper
+		// triangle of comoments (if there is one). Written the same way for both, so the covariance
+		// diagonal comes out exactly equal to the variance
+		auto add_deviations(std::span<double> const squared_deviations,
+		                    euclidean_matrix& comoments,
+		                    std::span<double const> const delta,
+		                    double const weight) noexcept -> void {
+			for (auto i = std::size_t{0}; i < delta.size(); ++i) {
+				squared_deviations[i] += (weight * delta[i]) * delta[i];
+			}
+			if (comoments.rows() == 0) {
+				return;
+			}
+			for (auto i = std::size_t{0}; i < delta.size(); ++i) {
+				// columns i onwards, in dot_lanes-wide groups like the dot kernel. Each group of delta
+				// is loaded before any of the row is written, so the compiler needn't worry about the
+				// two overlapping and vectorises the group
+				auto* const row = comoments.row(gsl_lite::narrow_cast<int>(i)).data();
+				auto const scale = weight * delta[i];
+				auto j = i;
+				for (; j + detail::dot_lanes <= delta.size(); j += detail::dot_lanes) {
+					auto group = std::array<double, detail::dot_lanes>{};
+					for (auto lane = std::size_t{0}; lane < detail::dot_lanes; ++lane) {
+						group[lane] = scale * delta[j + lane];
+					}
+					for (auto lane = std::size_t{0}; lane < detail::dot_lanes; ++lane) {
+						row[j + lane] += group[lane];
+					}
+				}
+				for (; j < delta.size(); ++j) {
+					row[j] += scale * delta[j];
+				}
+			}
+		}
+
+		auto without_samples(std::string const& statistic, std::size_t const minimum) -> euclidean_vector_error {
+			return euclidean_vector_error(statistic + " needs at least " + std::to_string(minimum) + " sample"
+			                              + (minimum == 1 ? "" : "s"));
+		}
+	} // namespace
+
+	running_statistics::running_statistics(int const dimensions, bool const covariance)
+	: covariance_(covariance)
+	, mean_(dimensions)
+	, squared_deviations_(dimensions)
+	, comoments_(covariance ? dimensions : 0, covariance ? dimensions : 0)
+	, delta_(dimensions) {}
+
+	auto running_statistics::add(euclidean_vector const& v) -> void {
+		check_dimensions(v.dimensions());
+		add(v, unchecked);
+	}
+
+	// Welford: the mean moves by delta / n, and the squared deviations grow by delta^2 (n - 1) / n
+	auto running_statistics::add(euclidean_vector const& v, unchecked_t) noexcept -> void {
+		assert(v.dimensions() == dimensions());
+		++count_;
+		auto const n = static_cast<double>(count_);
+		auto const x = storage(v);
+		auto const mean = writable(mean_);
+		auto const delta = writable(delta_);
+		for (auto i = std::size_t{0}; i < x.size(); ++i) {
+			delta[i] = x[i] - mean[i];
+			mean[i] += delta[i] / n;
+		}
+		add_deviations(writable(squared_deviations_),
+		               comoments_,
+		               delta,
+		               (n - 1) / n);
+	}
+
+	auto running_statistics::add(std::span<euclidean_vector const> const vectors, int const threads) -> void {
+		for (auto const& v : vectors) {
+			check_dimensions(v.dimensions());
+		}
+		add_rows(vectors.size(), [&](std::size_t const i) { return storage(vectors[i]); }, threads);
+	}
+
+	auto running_statistics::add(euclidean_matrix const& rows, int const threads) -> void {
+		if (rows.rows() != 0) {
+			check_dimensions(rows.columns());
+		}
+		add_rows(gsl_lite::narrow_cast<std::size_t>(rows.rows()),
+		         [&](std::size_t const i) { return rows.row(gsl_lite::narrow_cast<int>(i)); },
+		         threads);
+	}
+
+	// Each chunk of the batch is summarised in two passes (its mean, then deviations from that
+	// mean), which is as accurate as it gets, and merged in chunk order
+	template<typename Row>
+	auto running_statistics::add_rows(std::size_t const count, Row const& row, int const threads) -> void {
+		if (count == 0) {
+			return;
+		}
+		auto const chunks = std::min(detail::thread_count(threads), count);
+		// allocated here, as the workers mustn't throw
+		auto partials = std::vector<running_statistics>();
+		partials.reserve(chunks);
+		for (auto chunk = std::size_t{0}; chunk < chunks; ++chunk) {
+			partials.emplace_back(dimensions(), tracks_covariance());
+		}
+		detail::parallel_for(count,
+		                     chunks,
+		                     [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+			                     partials[chunk].summarise(begin, end, row);
+		                     });
+		for (auto const& partial : partials) {
+			merge(partial);
+		}
+	}
+
+	template<typename Row>
+	auto running_statistics::summarise(std::size_t const begin, std::size_t const end, Row const& row) noexcept
+	   -> void {
+		assert(count_ == 0);
+		count_ = end - begin;
+		auto const mean = writable(mean_);
+		for (auto r = begin; r < end; ++r) {
+			auto const x = row(r);
+			for (auto i = std::size_t{0}; i < x.size(); ++i) {
+				mean[i] += x[i];
+			}
+		}
+		auto const n = static_cast<double>(count_);
+		for (auto& m : mean) {
+			m /= n;
+		}
+
+		auto const squared_deviations = writable(squared_deviations_);
+		auto const delta = writable(delta_);
+		for (auto r = begin; r < end; ++r) {
+			auto const x = row(r);
+			for (auto i = std::size_t{0}; i < x.size(); ++i) {
+				delta[i] = x[i] - mean[i];
+			}
+			add_deviations(squared_deviations, comoments_, delta, 1.0);
+		}
+	}
+
+	// Chan et al.: with delta the difference between the two means, the mean moves by
+	// delta * n_b / n, and the squared deviations are the two sums plus delta^2 * n_a * n_b / n.
+	// With no samples here yet the mean is exactly zero, so this copies other exactly
+	auto running_statistics::merge(running_statistics const& other) -> void {
+		check_dimensions(other.dimensions());
+		if (tracks_covariance() and not other.tracks_covariance()) {
+			throw euclidean_vector_error("Cannot merge running_statistics without covariance into one with it");
+		}
+		if (other.count_ == 0) {
+			return;
+		}
+
+		auto const total = count_ + other.count_;
+		auto const n = static_cast<double>(total);
+		auto const fraction = static_cast<double>(other.count_) / n;
+		auto const weight = static_cast<double>(count_) * fraction;
+
+		auto const other_mean = storage(other.mean_);
+		auto const other_squared_deviations = storage(other.squared_deviations_);
+		auto const mean = writable(mean_);
+		auto const squared_deviations = writable(squared_deviations_);
+		auto const delta = writable(delta_);
+		for (auto i = std::size_t{0}; i < mean.size(); ++i) {
+			delta[i] = other_mean[i] - mean[i];
+			mean[i] += delta[i] * fraction;
+			squared_deviations[i] += other_squared_deviations[i];
+		}
+		for (auto i = 0; i < comoments_.rows(); ++i) {
+			auto const row = comoments_.row(i);
+			auto const other_row = other.comoments_.row(i);
+			for (auto j = gsl_lite::narrow_cast<std::size_t>(i); j < row.size(); ++j) {
+				row[j] += other_row[j];
+			}
+		}
+		add_deviations(squared_deviations, comoments_, delta, weight);
+		count_ = total;
+	}
+
+	auto running_statistics::reset() noexcept -> void {
+		count_ = 0;
+		ranges::fill(writable(mean_), 0.0);
+		ranges::fill(writable(squared_deviations_), 0.0);
+		for (auto i = 0; i < comoments_.rows(); ++i) {
+			ranges::fill(comoments_.row(i), 0.0);
+		}
+	}
+
+	[[nodiscard]] auto running_statistics::count() const noexcept -> std::size_t {
+		return count_;
+	}
+
+	[[nodiscard]] auto running_statistics::dimensions() const noexcept -> int {
+		return mean_.dimensions();
+	}
+
+	[[nodiscard]] auto running_statistics::tracks_covariance() const noexcept -> bool {
+		return covariance_;
+	}
+
+	[[nodiscard]] auto running_statistics::mean() const noexcept -> euclidean_vector const& {
+		return mean_;
+	}
+
+	[[nodiscard]] auto running_statistics::variance() const -> euclidean_vector {
+		return scaled_variance(1);
+	}
+
+	[[nodiscard]] auto running_statistics::sample_variance() const -> euclidean_vector {
+		return scaled_variance(2);
+	}
+
+	[[nodiscard]] auto running_statistics::covariance() const -> euclidean_matrix {
+		return scaled_covariance(1);
+	}
+
+	[[nodiscard]] auto running_statistics::sample_covariance() const -> euclidean_matrix {
+		return scaled_covariance(2);
+	}
+
+	auto running_statistics::check_dimensions(int const dimensions) const -> void {
+		if (dimensions != this->dimensions()) {
+			throw euclidean_vector_error("Dimensions of running_statistics and sample ("
+			                             + std::to_string(this->dimensions()) + " and "
+			                             + std::to_string(dimensions) + ") do not match");
+		}
+	}
+
+	// divided by count - (minimum - 1): population statistics for minimum 1, sample for 2
+	auto running_statistics::scaled_variance(std::size_t const minimum) const -> euclidean_vector {
+		if (count_ < minimum) {
+			throw without_samples(minimum == 1 ? "variance" : "sample_variance", minimum);
+		}
+		auto result = squared_deviations_;
+		result.divide(static_cast<double>(count_ - (minimum - 1)), unchecked);
+		return result;
+	}
+
+	auto running_statistics::scaled_covariance(std::size_t const minimum) const -> euclidean_matrix {
+		if (not tracks_covariance()) {
+			throw euclidean_vector_error("running_statistics is not tracking covariance");
+		}
+		if (count_ < minimum) {
+			throw without_samples(minimum == 1 ? "covariance" : "sample_covariance", minimum);
+		}
+		auto const divisor = static_cast<double>(count_ - (minimum - 1));
+		auto result = euclidean_matrix(dimensions(), dimensions());
+		for (auto i = 0; i < dimensions(); ++i) {
+			for (auto j = i; j < dimensions(); ++j) {
+				result(i, j) = comoments_(i, j) / divisor;
+				result(j, i) = result(i, j);
+			}
+		}
+		return result;
+	}
+
+} // namespace comp6771
@@ -0,0 +1,134 @@
+// Top-k selection with per-thread bounded heaps.
+//
+// Copyright (c) Vishal Bondwal, Apache 2.0 license
+
+#include "top_k.hpp"
+
+#include "dot_kernel.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <gsl/gsl-lite.hpp>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+
+	namespace {
+		// strict "ranks above": higher score, then lower index, so ties are settled the same way
+		// however the work was split
+		auto better(scored_index const& a, scored_index const& b) noexcept -> bool {
+			return a.score > b.score or (a.score == b.score and a.index < b.index);
+		}
+
+		// Best k of score(i) for i in [0, count). Each thread keeps a heap of its best k so far
+		// with the worst of them at the front, so a new candidate only has to beat the front
+		template<typename Score>
+		auto select(std::size_t const count, std::size_t k, int const threads, Score const& score)
+		   -> std::vector<scored_index> {
+			k = std::min(k, count);
+			if (k == 0) {
+				return {};
+			}
+
+			auto const chunks = std::min(detail::thread_count(threads), count);
+			auto heaps = std::vector<std::vector<scored_index>>(chunks);
+			for (auto& heap : heaps) {
+				heap.reserve(k); // allocated here, as the workers mustn't throw
+			}
+			detail::parallel_for(count,
+			                     chunks,
+			                     [&](std::size_t const chunk, std::size_t const begin, std::size_t const end) {
+				                     auto& heap = heaps[chunk];
+				                     for (auto i = begin; i < end; ++i) {
+					                     auto const candidate = scored_index{i, score(i)};
+					                     if (std::isnan(candidate.score)) {
+						                     continue;
+					                     }
+					                     if (heap.size() < k) {
+						                     heap.push_back(candidate);
+						                     ranges::push_heap(heap, better);
+					                     }
+					                     else if (better(candidate, heap.front())) {
+						                     ranges::pop_heap(heap, better);
+						                     heap.back() = candidate;
+						                     ranges::push_heap(heap, better);
+					                     }
+				                     }
+			                     });
+
+			// merge: at most k from each thread, of which the best k overall are kept
+			auto result = std::move(heaps.front());
+			for (auto const& heap : std::span(heaps).subspan(1)) {
+				result.insert(result.end(), heap.begin(), heap.end());
+			}
+			auto const kept = std::min(k, result.size());
+			auto const middle = result.begin() + gsl_lite::narrow_cast<std::ptrdiff_t>(kept);
+			std::partial_sort(result.begin(), middle, result.end(), better);
+			result.erase(middle, result.end());
+			return result;
+		}
+
+		auto storage(euclidean_vector const& v) noexcept -> std::span<double const> {
+			return std::span<double const>(v.data(), v.size());
+		}
+	} // namespace
+
+	auto top_k_by_norm(std::span<euclidean_vector const> const vectors, std::size_t const k, int const threads)
+	   -> std::vector<scored_index> {
+		return select(vectors.size(), k, threads, [&](std::size_t const i) {
+			auto const v = storage(vectors[i]);
+			return std::sqrt(detail::dot(v, v));
+		});
+	}
+
+	auto top_k_by_norm(euclidean_matrix const& rows, std::size_t const k, int const threads)
+	   -> std::vector<scored_index> {
+		return select(gsl_lite::narrow_cast<std::size_t>(rows.rows()), k, threads, [&](std::size_t const i) {
+			auto const row = rows.row(gsl_lite::narrow_cast<int>(i));
+			return std::sqrt(detail::dot(row, row));
+		});
+	}
+
+	auto top_k_by_dot(euclidean_vector const& query,
+	                  std::span<euclidean_vector const> const vectors,
+	                  std::size_t const k,
+	                  int const threads) -> std::vector<scored_index> {
+		// all checked before any thread starts, as the workers mustn't throw
+		for (auto const& v : vectors) {
+			if (v.dimensions() != query.dimensions()) {
+				throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(query.dimensions())
+				                             + ") and RHS(" + std::to_string(v.dimensions())
+				                             + ") do not match");
+			}
+		}
+		return select(vectors.size(), k, threads, [&](std::size_t const i) {
+			return dot(vectors[i], query, unchecked);
+		});
+	}
+
+	auto top_k_by_dot(euclidean_vector const& query,
+	                  euclidean_matrix const& rows,
+	                  std::size_t const k,
+	                  int const threads) -> std::vector<scored_index> {
+		if (rows.columns() != query.dimensions()) {
+			throw euclidean_vector_error("Dimensions of matrix columns and euclidean_vector ("
+			                             + std::to_string(rows.columns()) + " and "
+			                             + std::to_string(query.dimensions()) + ") do not match");
+		}
+		auto const q = storage(query);
+		return select(gsl_lite::narrow_cast<std::size_t>(rows.rows()), k, threads, [&](std::size_t const i) {
+			return detail::dot(rows.row(gsl_lite::narrow_cast<int>(i)), q);
+		});
+	}
+
+	auto top_k(std::span<double const> const scores, std::size_t const k, int const threads)
+	   -> std::vector<scored_index> {
+		return select(scores.size(), k, threads, [&](std::size_t const i) { return scores[i]; });
+	}
+
+} // namespace comp6771
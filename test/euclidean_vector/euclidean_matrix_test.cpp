@@ -0,0 +1,224 @@
+// tests the dense matrix type and its products with euclidean_vectors
+#include "comp6771/euclidean_matrix.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <vector>
+
+namespace {
+	// deterministic, non-trivial test values (small integers, so every product is exact)
+	auto filled_matrix(int rows, int columns, int seed) -> comp6771::euclidean_matrix {
+		auto m = comp6771::euclidean_matrix(rows, columns);
+		for (auto r = 0; r < rows; ++r) {
+			for (auto c = 0; c < columns; ++c) {
+				m(r, c) = static_cast<double>((r * 7 + c * 3 + seed) % 11 - 5);
+			}
+		}
+		return m;
+	}
+
+	auto naive_multiply(comp6771::euclidean_matrix const& a, comp6771::euclidean_matrix const& b)
+	   -> comp6771::euclidean_matrix {
+		auto result = comp6771::euclidean_matrix(a.rows(), b.columns());
+		for (auto i = 0; i < a.rows(); ++i) {
+			for (auto j = 0; j < b.columns(); ++j) {
+				for (auto k = 0; k < a.columns(); ++k) {
+					result(i, j) += a(i, k) * b(k, j);
+				}
+			}
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("Matrix construction and access") {
+	SECTION("Initialiser list is row-major") {
+		auto const m = comp6771::euclidean_matrix(2, 3, {1, 2, 3, 4, 5, 6});
+		CHECK(m.rows() == 2);
+		CHECK(m.columns() == 3);
+		CHECK(m(1, 0) == 4);
+		CHECK(fmt::format("{}", m) == "[1 2 3]\n[4 5 6]\n");
+	}
+
+	SECTION("Wrong number of initialisers throws") {
+		CHECK_THROWS_AS(comp6771::euclidean_matrix(2, 2, {1, 2, 3}), comp6771::euclidean_vector_error);
+	}
+
+	SECTION("Rows from euclidean_vectors, and back") {
+		auto const vectors =
+		   std::vector<comp6771::euclidean_vector>{{1, 2}, {3, 4}, {5, 6}};
+		auto const m = comp6771::euclidean_matrix(vectors);
+		CHECK(m.rows() == 3);
+		CHECK(m.row_vector(2) == vectors[2]);
+		CHECK(m.row(1)[1] == 4);
+	}
+
+	SECTION("Every row starts on a cache line") {
+		auto const m = comp6771::euclidean_matrix(3, 5, 1.0); // 5 columns, so rows need padding
+		for (auto r = 0; r < m.rows(); ++r) {
+			auto const address = reinterpret_cast<std::uintptr_t>(m.row(r).data());
+			CHECK(address % comp6771::euclidean_vector::storage_alignment == 0);
+			CHECK(m.row(r).size() == 5);
+		}
+		CHECK(m == comp6771::euclidean_matrix(3, 5, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}));
+	}
+
+	SECTION("Copy and move") {
+		auto m1 = comp6771::euclidean_matrix(2, 2, {1, 2, 3, 4});
+		auto m2 = m1;
+		CHECK(m1 == m2);
+		m2(0, 0) = 9;
+		CHECK(m1 != m2);
+		auto m3 = std::move(m2);
+		CHECK(m3(0, 0) == 9);
+	}
+}
+
+TEST_CASE("Matrix-vector product") {
+	SECTION("Small product") {
+		auto const m = comp6771::euclidean_matrix(2, 3, {1, 2, 3, 4, 5, 6});
+		auto const x = comp6771::euclidean_vector{1, 0, -1};
+		CHECK(fmt::format("{}", m * x) == "[-2 -2]");
+	}
+
+	SECTION("Matches one dot() per row across blocks and thread counts") {
+		// wider than one column block, and a row count that isn't a multiple of the row group
+		auto const m = filled_matrix(7, 5000, 1);
+		auto x = comp6771::euclidean_vector(5000);
+		for (auto i = 0; i < x.dimensions(); ++i) {
+			x[i] = static_cast<double>(i % 5 - 2);
+		}
+		auto expected = comp6771::euclidean_vector(7);
+		for (auto r = 0; r < 7; ++r) {
+			expected[r] = comp6771::dot(m.row_vector(r), x);
+		}
+		CHECK(m * x == expected);
+		CHECK(comp6771::multiply(m, x, 3) == expected);
+		CHECK(comp6771::multiply(m, x, 0) == expected);
+	}
+
+	SECTION("Mismatched dimensions throw") {
+		auto const m = comp6771::euclidean_matrix(2, 3);
+		CHECK_THROWS_AS(m * comp6771::euclidean_vector(2), comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Matrix-matrix products") {
+	SECTION("Small product") {
+		auto const a = comp6771::euclidean_matrix(2, 2, {1, 2, 3, 4});
+		auto const b = comp6771::euclidean_matrix(2, 2, {5, 6, 7, 8});
+		CHECK(a * b == comp6771::euclidean_matrix(2, 2, {19, 22, 43, 50}));
+	}
+
+	SECTION("Blocked product matches the naive triple loop") {
+		auto const a = filled_matrix(37, 300, 2);
+		auto const b = filled_matrix(300, 600, 5);
+		auto const expected = naive_multiply(a, b);
+		CHECK(a * b == expected);
+		CHECK(comp6771::multiply(a, b, 4) == expected);
+	}
+
+	SECTION("multiply_transposed gives one dot per pair of rows") {
+		auto const a = filled_matrix(9, 70, 3);
+		auto const b = filled_matrix(70, 13, 4);
+		auto bt = comp6771::euclidean_matrix(13, 70);
+		for (auto r = 0; r < 13; ++r) {
+			for (auto c = 0; c < 70; ++c) {
+				bt(r, c) = b(c, r);
+			}
+		}
+		CHECK(comp6771::multiply_transposed(a, bt, 2) == naive_multiply(a, b));
+	}
+
+	SECTION("Mismatched dimensions throw") {
+		auto const a = comp6771::euclidean_matrix(2, 3);
+		CHECK_THROWS_AS(a * a, comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::multiply_transposed(a, comp6771::euclidean_matrix(2, 2), 1),
+		                comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Gram and distance matrices into a caller's buffer") {
+	// more rows than a Gram tile, and a column count that isn't a whole number of lanes
+	auto const a = filled_matrix(70, 37, 1);
+	auto const b = filled_matrix(130, 37, 2);
+	auto out = std::vector<double>(70 * 130);
+
+	SECTION("gram matches multiply_transposed") {
+		comp6771::gram(a, b, out, 3);
+		auto const expected = comp6771::multiply_transposed(a, b, 1);
+		for (auto i = 0; i < 70; ++i) {
+			for (auto j = 0; j < 130; ++j) {
+				CHECK(out[static_cast<std::size_t>(i * 130 + j)] == expected(i, j));
+			}
+		}
+	}
+
+	SECTION("Distances match euclidean_norm(a - b)") {
+		auto squared = std::vector<double>(out.size());
+		comp6771::pairwise_distances(a, b, out, 4);
+		comp6771::pairwise_squared_distances(a, b, squared, 1);
+		for (auto i = 0; i < 70; ++i) {
+			for (auto j = 0; j < 130; ++j) {
+				auto const expected = comp6771::euclidean_norm(a.row_vector(i) - b.row_vector(j));
+				auto const k = static_cast<std::size_t>(i * 130 + j);
+				CHECK(out[k] == Approx(expected));
+				CHECK(squared[k] == Approx(expected * expected));
+			}
+		}
+	}
+
+	SECTION("Distances within one matrix have a zero diagonal") {
+		auto self = std::vector<double>(70 * 70);
+		comp6771::pairwise_distances(a, a, self, 2);
+		for (auto i = 0; i < 70; ++i) {
+			CHECK(self[static_cast<std::size_t>(i * 71)] == 0.0);
+			for (auto j = 0; j < 70; ++j) {
+				CHECK(self[static_cast<std::size_t>(i * 70 + j)] == self[static_cast<std::size_t>(j * 70 + i)]);
+			}
+		}
+	}
+
+	SECTION("Bad buffers and mismatched columns throw") {
+		auto small = std::vector<double>(70 * 130 - 1);
+		CHECK_THROWS_MATCHES(comp6771::gram(a, b, small),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of output buffer and result (9099 and 9100) do not match"));
+		CHECK_THROWS_AS(comp6771::pairwise_distances(a, b, small), comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::pairwise_distances(a, filled_matrix(130, 36, 2), out),
+		                comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::pairwise_squared_distances(a, filled_matrix(130, 36, 2), out),
+		                comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Normalising matrix rows") {
+	auto m = comp6771::euclidean_matrix(4, 2, {3, 4, 0, 0, 1e200, 0, -6, 8});
+	auto const skipped = comp6771::normalise_rows(m, 2);
+	CHECK(skipped == std::vector<std::size_t>{1});
+	CHECK(m == comp6771::euclidean_matrix(4, 2, {0.6, 0.8, 0, 0, 1, 0, -0.6, 0.8}));
+
+	SECTION("Same results as normalise() on the rows as vectors") {
+		auto big = comp6771::euclidean_matrix(37, 19);
+		for (auto i = 0; i < big.rows(); ++i) {
+			for (auto j = 0; j < big.columns(); ++j) {
+				big(i, j) = (i * 7 + j * 3) % 11 - 5.0;
+			}
+		}
+		auto rows = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < big.rows(); ++i) {
+			rows.push_back(big.row_vector(i));
+		}
+		CHECK(comp6771::normalise_rows(big, 0) == comp6771::normalise(rows, 3));
+		for (auto i = 0; i < big.rows(); ++i) {
+			CHECK(big.row_vector(i) == rows[static_cast<std::size_t>(i)]);
+		}
+	}
+
+	SECTION("No columns") {
+		auto empty = comp6771::euclidean_matrix(3, 0);
+		CHECK(comp6771::normalise_rows(empty) == std::vector<std::size_t>{0, 1, 2});
+	}
+}
@@ -0,0 +1,71 @@
+// tests the sharded multi-threaded accumulator
+#include "comp6771/euclidean_vector_accumulator.hpp"
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Accumulating on one thread") {
+	auto accumulator = comp6771::euclidean_vector_accumulator(3);
+	CHECK(accumulator.dimensions() == 3);
+	CHECK(accumulator.shards() == 0);
+	CHECK(accumulator.total() == comp6771::euclidean_vector(3));
+
+	accumulator.add(comp6771::euclidean_vector{1, 2, 3});
+	accumulator.add(comp6771::euclidean_vector{1, 1, 1});
+	accumulator.local().axpy(2, comp6771::euclidean_vector{1, 0, 0});
+	CHECK(accumulator.shards() == 1);
+	CHECK(accumulator.total() == comp6771::euclidean_vector{4, 3, 4});
+
+	CHECK_THROWS_MATCHES(accumulator.add(comp6771::euclidean_vector{1, 2}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+
+	accumulator.reset();
+	CHECK(accumulator.total() == comp6771::euclidean_vector(3));
+	CHECK(accumulator.shards() == 1);
+}
+
+TEST_CASE("Accumulating from many threads") {
+	constexpr auto threads = 8;
+	constexpr auto adds = 1000;
+	auto accumulator = comp6771::euclidean_vector_accumulator(16);
+	auto const one = comp6771::euclidean_vector(16, 1.0);
+
+	{
+		auto workers = std::vector<std::jthread>();
+		for (auto t = 0; t < threads; ++t) {
+			workers.emplace_back([&] {
+				for (auto i = 0; i < adds; ++i) {
+					accumulator.add(one);
+				}
+			});
+		}
+	}
+	CHECK(accumulator.shards() == threads);
+	CHECK(accumulator.total() == comp6771::euclidean_vector(16, threads * adds));
+}
+
+TEST_CASE("A thread can use several accumulators") {
+	auto first = comp6771::euclidean_vector_accumulator(2);
+	auto second = comp6771::euclidean_vector_accumulator(2);
+	for (auto i = 0; i < 3; ++i) {
+		first.add(comp6771::euclidean_vector{1, 0});
+		second.add(comp6771::euclidean_vector{0, 1});
+	}
+	CHECK(first.shards() == 1);
+	CHECK(second.shards() == 1);
+	CHECK(first.total() == comp6771::euclidean_vector{3, 0});
+	CHECK(second.total() == comp6771::euclidean_vector{0, 3});
+
+	// an accumulator created where a destroyed one used to be starts empty
+	{
+		auto temporary = comp6771::euclidean_vector_accumulator(2);
+		temporary.add(comp6771::euclidean_vector{5, 5});
+	}
+	auto third = comp6771::euclidean_vector_accumulator(2);
+	third.add(comp6771::euclidean_vector{1, 1});
+	CHECK(third.total() == comp6771::euclidean_vector{1, 1});
+}
@@ -0,0 +1,154 @@
+// tests content hashing of euclidean_vector and the deduplicating euclidean_vector_cache
+#include "comp6771/euclidean_vector_cache.hpp"
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/hash/hash.h>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <limits>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Content hash") {
+	SECTION("Equal vectors hash equal") {
+		auto const a = comp6771::euclidean_vector{1.5, -2.0, 3.25, 4.0, 5.5};
+		auto const b = comp6771::euclidean_vector{1.5, -2.0, 3.25, 4.0, 5.5};
+		CHECK(a.content_hash() == b.content_hash());
+		CHECK(absl::Hash<comp6771::euclidean_vector>{}(a) == absl::Hash<comp6771::euclidean_vector>{}(b));
+	}
+
+	SECTION("Negative zero hashes like zero, since they compare equal") {
+		auto const a = comp6771::euclidean_vector{0.0, 1.0, -0.0};
+		auto const b = comp6771::euclidean_vector{-0.0, 1.0, 0.0};
+		REQUIRE(a == b);
+		CHECK(a.content_hash() == b.content_hash());
+	}
+
+	SECTION("Different vectors hash differently") {
+		CHECK(comp6771::euclidean_vector{1, 2, 3}.content_hash()
+		      != comp6771::euclidean_vector{3, 2, 1}.content_hash());
+		CHECK(comp6771::euclidean_vector(0).content_hash()
+		      != comp6771::euclidean_vector(1, 0.0).content_hash());
+		CHECK(comp6771::euclidean_vector(3, 0.0).content_hash()
+		      != comp6771::euclidean_vector(4, 0.0).content_hash());
+
+		// one-element changes anywhere, including in every lane and the tail
+		auto hashes = absl::flat_hash_set<std::uint64_t>();
+		auto ev = comp6771::euclidean_vector(11, 1.0);
+		hashes.insert(ev.content_hash());
+		for (auto i = 0; i < ev.dimensions(); ++i) {
+			ev[i] = 2.0;
+			hashes.insert(ev.content_hash());
+			ev[i] = 1.0;
+		}
+		CHECK(hashes.size() == 12);
+	}
+
+	SECTION("Usable as a key in absl containers") {
+		auto set = absl::flat_hash_set<comp6771::euclidean_vector>();
+		set.insert(comp6771::euclidean_vector{1, 2});
+		set.insert(comp6771::euclidean_vector{1, 2});
+		set.insert(comp6771::euclidean_vector{2, 1});
+		CHECK(set.size() == 2);
+		CHECK(set.contains(comp6771::euclidean_vector{2, 1}));
+	}
+}
+
+TEST_CASE("Deduplicating cache") {
+	SECTION("Computes once per distinct vector") {
+		auto cache = comp6771::euclidean_vector_cache<comp6771::euclidean_vector>(8);
+		auto calls = 0;
+		auto const unit = [&calls](comp6771::euclidean_vector const& v) {
+			++calls;
+			return comp6771::unit(v);
+		};
+
+		auto const a = comp6771::euclidean_vector{3, 4};
+		CHECK(cache.get_or_compute(a, unit) == comp6771::euclidean_vector{0.6, 0.8});
+		CHECK(cache.get_or_compute(comp6771::euclidean_vector{3, 4}, unit)
+		      == comp6771::euclidean_vector{0.6, 0.8});
+		CHECK(cache.get_or_compute(comp6771::euclidean_vector{0, 2}, unit)
+		      == comp6771::euclidean_vector{0, 1});
+		CHECK(calls == 2);
+		CHECK(cache.size() == 2);
+		CHECK(cache.hits() == 1);
+		CHECK(cache.misses() == 2);
+
+		cache.clear();
+		CHECK(cache.size() == 0);
+		cache.get_or_compute(a, unit);
+		CHECK(calls == 3);
+	}
+
+	SECTION("Evicts the least recently used entry") {
+		auto cache = comp6771::euclidean_vector_cache<double>(2);
+		auto const norm = [](comp6771::euclidean_vector const& v) {
+			return comp6771::euclidean_norm(v);
+		};
+		auto const a = comp6771::euclidean_vector{1};
+		auto const b = comp6771::euclidean_vector{2};
+		auto const c = comp6771::euclidean_vector{3};
+
+		cache.get_or_compute(a, norm);
+		cache.get_or_compute(b, norm);
+		cache.get_or_compute(a, norm); // b is now least recently used
+		cache.get_or_compute(c, norm); // evicts b
+		CHECK(cache.size() == 2);
+
+		auto const misses = cache.misses();
+		cache.get_or_compute(a, norm);
+		cache.get_or_compute(c, norm);
+		CHECK(cache.misses() == misses);
+		cache.get_or_compute(b, norm);
+		CHECK(cache.misses() == misses + 1);
+	}
+
+	SECTION("Keys containing NaN are never hit, and are still evicted") {
+		auto cache = comp6771::euclidean_vector_cache<double>(1);
+		auto calls = 0;
+		auto const count = [&calls](comp6771::euclidean_vector const&) { return ++calls; };
+		auto const nan = comp6771::euclidean_vector{std::numeric_limits<double>::quiet_NaN(), 1};
+
+		CHECK(cache.get_or_compute(nan, count) == 1);
+		CHECK(cache.get_or_compute(nan, count) == 2);
+		CHECK(cache.size() == 1);
+		CHECK(cache.get_or_compute(comp6771::euclidean_vector{2}, count) == 3); // evicts the NaN entry
+		CHECK(cache.get_or_compute(comp6771::euclidean_vector{2}, count) == 3);
+		CHECK(cache.get_or_compute(nan, count) == 4);
+		CHECK(cache.size() == 1);
+		CHECK(cache.hits() == 1);
+		CHECK(cache.misses() == 4);
+	}
+
+	SECTION("Safe to share between threads") {
+		auto cache = comp6771::euclidean_vector_cache<double>(16);
+		auto const keys = std::vector<comp6771::euclidean_vector>{
+		   comp6771::euclidean_vector{1, 0},
+		   comp6771::euclidean_vector{0, 2},
+		   comp6771::euclidean_vector{3, 4},
+		};
+		auto wrong = std::atomic<int>(0);
+		{
+			auto workers = std::vector<std::jthread>();
+			for (auto t = 0; t < 4; ++t) {
+				workers.emplace_back([&] {
+					for (auto i = 0; i < 1000; ++i) {
+						auto const& key = keys[static_cast<std::size_t>(i) % keys.size()];
+						auto const norm = cache.get_or_compute(key, [](auto const& v) {
+							return comp6771::euclidean_norm(v);
+						});
+						if (norm != comp6771::euclidean_norm(key)) {
+							++wrong;
+						}
+					}
+				});
+			}
+		}
+		CHECK(wrong == 0);
+		CHECK(cache.size() == 3);
+		CHECK(cache.hits() + cache.misses() == 4000);
+		CHECK(cache.hits() >= 4000 - 4 * 3);
+	}
+}
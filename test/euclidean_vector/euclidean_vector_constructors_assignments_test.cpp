@@ -5,6 +5,15 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <array>
+#include <cstdint>
+#include <list>
+#include <range/v3/view/istream.hpp>
+#include <span>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 TEST_CASE("Basic constructor test") { // this is the constructor with (dimensions, magnitude)
 	                                   // arguments
 	SECTION("Basic constructor with const objects and rvalue arguments") {
@@ -74,6 +83,53 @@ TEST_CASE("std::vector iterator constructor") {
 	}
 }
 
+TEST_CASE("Generic range constructor") {
+	SECTION("From std::array (contiguous double, bulk copy path)") {
+		auto const arr = std::array<double, 3>{1.5, 2.5, 3.5};
+		auto const ev = comp6771::euclidean_vector(arr);
+		CHECK(fmt::format("{}", ev) == "[1.5 2.5 3.5]");
+	}
+
+	SECTION("From a std::span over a raw buffer") {
+		double raw[] = {4, 5, 6, 7}; // NOLINT(modernize-avoid-c-arrays)
+		auto const ev = comp6771::euclidean_vector(std::span<double const>(raw));
+		CHECK(ev.dimensions() == 4);
+		CHECK(fmt::format("{}", ev) == "[4 5 6 7]");
+	}
+
+	SECTION("From float and int sources, converting element types") {
+		auto const floats = std::vector<float>{0.5F, 1.25F};
+		auto const ints = std::list<int>{1, 2, 3};
+		CHECK(fmt::format("{}", comp6771::euclidean_vector(floats)) == "[0.5 1.25]");
+		CHECK(fmt::format("{}", comp6771::euclidean_vector(ints)) == "[1 2 3]");
+	}
+
+	SECTION("From an iterator pair that is not a std::vector<double>::const_iterator") {
+		auto const arr = std::array<int, 4>{9, 8, 7, 6};
+		auto const ev = comp6771::euclidean_vector(arr.begin() + 1, arr.end());
+		CHECK(fmt::format("{}", ev) == "[8 7 6]");
+	}
+
+	SECTION("From a single-pass input range") {
+		auto in = std::istringstream("1 2 3.5");
+		auto const ev = comp6771::euclidean_vector(ranges::istream_view<double>(in));
+		CHECK(fmt::format("{}", ev) == "[1 2 3.5]");
+	}
+
+	SECTION("From an empty range") {
+		auto const empty = std::vector<double>();
+		auto const ev = comp6771::euclidean_vector(empty);
+		CHECK(ev.dimensions() == 0);
+		CHECK(fmt::format("{}", ev) == "[]");
+	}
+
+	SECTION("Copying a non-const euclidean_vector still uses the copy constructor") {
+		auto ev1 = comp6771::euclidean_vector{1, 2};
+		auto ev2 = comp6771::euclidean_vector(ev1);
+		CHECK(ev1 == ev2);
+	}
+}
+
 TEST_CASE("Copy constructor tests") {
 	SECTION("Using basic constructor and const input to copy constructor") {
 		auto const a1 = comp6771::euclidean_vector(3, 3.0);
@@ -171,3 +227,171 @@ TEST_CASE("Move assignment tests") {
 		CHECK(ev2.dimensions() == 0);
 	}
 }
+
+TEST_CASE("Storage is cache-line aligned") {
+	auto const is_aligned = [](double const* p) {
+		return reinterpret_cast<std::uintptr_t>(p) % comp6771::euclidean_vector::storage_alignment == 0;
+	};
+
+	SECTION("Every constructor") {
+		auto const values = std::vector<double>{1, 2, 3};
+		auto ev1 = comp6771::euclidean_vector(5, 1.0);
+		auto ev2 = comp6771::euclidean_vector{1, 2, 3};
+		auto ev3 = comp6771::euclidean_vector(values.begin(), values.end());
+		auto ev4 = comp6771::euclidean_vector(values);
+		auto ev5 = comp6771::euclidean_vector(ev1);
+		CHECK(is_aligned(&ev1[0]));
+		CHECK(is_aligned(&ev2[0]));
+		CHECK(is_aligned(&ev3[0]));
+		CHECK(is_aligned(&ev4[0]));
+		CHECK(is_aligned(&ev5[0]));
+	}
+
+	SECTION("Copy assignment reallocates aligned storage") {
+		auto ev1 = comp6771::euclidean_vector(3);
+		ev1 = comp6771::euclidean_vector(17, 2.0);
+		CHECK(is_aligned(&ev1[0]));
+		CHECK(ev1.dimensions() == 17);
+	}
+
+	SECTION("A cache line holds a whole number of lanes") {
+		CHECK(comp6771::euclidean_vector::storage_lanes * sizeof(double)
+		      == comp6771::euclidean_vector::storage_alignment);
+	}
+}
+
+TEST_CASE("Copy-on-write sharing") {
+	SECTION("Off by default: copies get their own storage") {
+		auto const ev1 = comp6771::euclidean_vector{1, 2, 3};
+		auto const ev2 = ev1;
+		CHECK_FALSE(ev1.shares_on_copy());
+		CHECK_FALSE(ev2.shares_storage_with(ev1));
+	}
+
+	SECTION("Copies share storage until one is modified") {
+		auto ev1 = comp6771::euclidean_vector{1, 2, 3};
+		ev1.share_on_copy(true);
+		auto ev2 = ev1;
+		auto ev3 = comp6771::euclidean_vector(1);
+		ev3 = ev2;
+		CHECK(ev2.shares_on_copy());
+		CHECK(ev2.shares_storage_with(ev1));
+		CHECK(ev3.shares_storage_with(ev1));
+
+		ev2[0] = 10;
+		CHECK_FALSE(ev2.shares_storage_with(ev1));
+		CHECK(ev3.shares_storage_with(ev1));
+		CHECK(ev1 == comp6771::euclidean_vector{1, 2, 3});
+		CHECK(ev2 == comp6771::euclidean_vector{10, 2, 3});
+
+		// the last sharer writes in place
+		ev3.at(1) = 20;
+		CHECK_FALSE(ev3.shares_storage_with(ev1));
+		auto const* const storage = &ev1[0];
+		ev1 *= 2;
+		CHECK(&ev1[0] == storage);
+		CHECK(ev1 == comp6771::euclidean_vector{2, 4, 6});
+		CHECK(ev3 == comp6771::euclidean_vector{1, 20, 3});
+	}
+
+	SECTION("Every mutating operation detaches first") {
+		auto original = comp6771::euclidean_vector{1, 2, 3};
+		original.share_on_copy(true);
+		auto const expected = comp6771::euclidean_vector{1, 2, 3};
+		auto const other = comp6771::euclidean_vector{1, 1, 1};
+
+		auto copy = original;
+		copy += other;
+		copy = original;
+		copy -= other;
+		copy = original;
+		copy /= 2;
+		copy = original;
+		copy.axpy(2, other);
+		copy = original;
+		copy.axpby(1, other, 2);
+		copy = original;
+		copy.lerp(other, 0.5);
+		copy = original;
+		copy.fma(other, other);
+		copy = original;
+		copy.transform([](double const x) { return x + 1; });
+		copy = original;
+		copy.transform(other, [](double const x, double const y) { return x * y + 1; });
+		copy = original;
+		copy += copy; // aliasing a vector that shares storage with another
+		CHECK(copy == comp6771::euclidean_vector{2, 4, 6});
+
+		CHECK(original == expected);
+		CHECK(-original == comp6771::euclidean_vector{-1, -2, -3});
+		CHECK(original + other == comp6771::euclidean_vector{2, 3, 4});
+		CHECK(original - other == comp6771::euclidean_vector{0, 1, 2});
+		CHECK(original * 2 == comp6771::euclidean_vector{2, 4, 6});
+		CHECK(original / 2 == comp6771::euclidean_vector{0.5, 1, 1.5});
+		CHECK(original == expected);
+	}
+
+	SECTION("Turning sharing off detaches") {
+		auto ev1 = comp6771::euclidean_vector(1000, 1.0);
+		ev1.share_on_copy(true);
+		auto ev2 = ev1;
+		ev2.share_on_copy(false);
+		CHECK_FALSE(ev2.shares_storage_with(ev1));
+		CHECK(ev2 == ev1);
+		auto const ev3 = ev2;
+		CHECK_FALSE(ev3.shares_storage_with(ev2));
+	}
+
+	SECTION("Sharers can be modified from different threads") {
+		auto original = comp6771::euclidean_vector(10000, 1.0);
+		original.share_on_copy(true);
+		auto copies = std::vector<comp6771::euclidean_vector>(4, original);
+		{
+			auto workers = std::vector<std::jthread>();
+			for (auto t = std::size_t{0}; t < copies.size(); ++t) {
+				workers.emplace_back([&copies, t] { copies[t] *= static_cast<double>(t + 2); });
+			}
+		}
+		for (auto t = std::size_t{0}; t < copies.size(); ++t) {
+			CHECK(copies[t] == comp6771::euclidean_vector(10000, static_cast<double>(t + 2)));
+		}
+		CHECK(original == comp6771::euclidean_vector(10000, 1.0));
+	}
+}
+
+TEST_CASE("Allocation policy") {
+	constexpr auto large = 1 << 19; // 4 MiB of magnitudes, more than a huge page
+
+	SECTION("Same values as the ordinary constructor") {
+		auto const policies = {comp6771::allocation_policy{},
+		                       comp6771::allocation_policy{true, 1},
+		                       comp6771::allocation_policy{false, 4},
+		                       comp6771::allocation_policy{true, 0}};
+		for (auto const policy : policies) {
+			auto const ev = comp6771::euclidean_vector(large + 3, 2.5, policy);
+			CHECK(ev == comp6771::euclidean_vector(large + 3, 2.5));
+			CHECK(ev.uses_huge_pages() == policy.huge_pages);
+		}
+		CHECK(comp6771::euclidean_vector(5, 1.0, {true, 8}) == comp6771::euclidean_vector(5, 1.0));
+		CHECK(comp6771::euclidean_vector(0, 1.0, {true, 8}).dimensions() == 0);
+	}
+
+	SECTION("Small vectors ignore huge pages") {
+		CHECK_FALSE(comp6771::euclidean_vector(100, 1.0, {true, 1}).uses_huge_pages());
+	}
+
+	SECTION("Copies inherit huge pages") {
+		auto ev = comp6771::euclidean_vector(large, 1.0, {true, 1});
+		auto const copy = ev;
+		CHECK(copy.uses_huge_pages());
+		auto assigned = comp6771::euclidean_vector(1);
+		assigned = ev;
+		CHECK(assigned.uses_huge_pages());
+
+		ev.share_on_copy(true);
+		auto shared = ev;
+		shared[0] = 2.0; // detaches
+		CHECK(shared.uses_huge_pages());
+		CHECK_FALSE(shared.shares_storage_with(ev));
+	}
+}
@@ -2,10 +2,15 @@
 
 #include "comp6771/euclidean_vector.hpp"
 
+#include <bit>
 #include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <iostream>
+#include <limits>
+#include <random>
 
 TEST_CASE("Boolean operator== tests") {
 	SECTION("Single dimensional default vectors") {
@@ -308,6 +313,45 @@ TEST_CASE("Euclidean norm") {
 	}
 }
 
+TEST_CASE("Scaled (overflow and underflow safe) euclidean norm") {
+	SECTION("Same as the fast norm for ordinary magnitudes") {
+		auto ev = comp6771::euclidean_vector{3, 4};
+		CHECK(comp6771::euclidean_norm(ev, comp6771::norm_mode::scaled) == 5);
+		CHECK(comp6771::euclidean_norm(ev, comp6771::norm_mode::fast) == 5);
+	}
+
+	SECTION("Huge magnitudes don't overflow") {
+		auto ev = comp6771::euclidean_vector{3e200, 4e200};
+		CHECK(std::isinf(comp6771::euclidean_norm(ev)));
+		CHECK(comp6771::euclidean_norm(ev, comp6771::norm_mode::scaled) == Approx(5e200));
+	}
+
+	SECTION("Tiny magnitudes don't underflow") {
+		auto ev = comp6771::euclidean_vector{3e-200, 4e-200};
+		CHECK(comp6771::euclidean_norm(ev) == 0);
+		CHECK(comp6771::euclidean_norm(ev, comp6771::norm_mode::scaled) == Approx(5e-200));
+	}
+
+	SECTION("Zero vector, infinity and NaN") {
+		auto const nan = std::numeric_limits<double>::quiet_NaN();
+		auto const inf = std::numeric_limits<double>::infinity();
+		auto const scaled = comp6771::norm_mode::scaled;
+		CHECK(comp6771::euclidean_norm(comp6771::euclidean_vector(4), scaled) == 0);
+		CHECK(std::isinf(comp6771::euclidean_norm(comp6771::euclidean_vector{1, inf}, scaled)));
+		CHECK(std::isnan(comp6771::euclidean_norm(comp6771::euclidean_vector{1, nan}, scaled)));
+	}
+
+	SECTION("unit() works for extreme magnitudes") {
+		auto const expected = comp6771::euclidean_vector{0.6, 0.8};
+		auto const big = comp6771::unit(comp6771::euclidean_vector{3e200, 4e200});
+		auto const small = comp6771::unit(comp6771::euclidean_vector{3e-200, 4e-200});
+		CHECK(big[0] == Approx(expected[0]));
+		CHECK(big[1] == Approx(expected[1]));
+		CHECK(small[0] == Approx(expected[0]));
+		CHECK(small[1] == Approx(expected[1]));
+	}
+}
+
 TEST_CASE("Unit vector") {
 	SECTION("Dimensionality of vector and its unit vector should be same") {
 		auto ev = comp6771::euclidean_vector{2.2, 3.3, 4.4};
@@ -337,4 +381,59 @@ TEST_CASE("Unit vector") {
 		CHECK(uv[0] == 0.6);
 		CHECK(uv[1] == 0.8);
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("Reproducible reductions") {
+	// an awkward length: several blocks, the last one partial and not a whole number of lanes
+	constexpr auto dimensions = static_cast<int>(comp6771::reproducible_block) * 5 + 4099;
+	auto engine = std::mt19937_64(7);
+	auto distribution = std::uniform_real_distribution<double>(-1e6, 1e6);
+	auto a = comp6771::euclidean_vector(dimensions);
+	auto b = comp6771::euclidean_vector(dimensions);
+	for (auto i = 0; i < dimensions; ++i) {
+		a[i] = distribution(engine);
+		b[i] = distribution(engine);
+	}
+	auto const bits = [](double const x) { return std::bit_cast<std::uint64_t>(x); };
+
+	SECTION("Bitwise identical for every thread count") {
+		auto const sum = comp6771::reproducible_sum(a);
+		auto const dot = comp6771::reproducible_dot(a, b);
+		auto const norm = comp6771::reproducible_norm(a);
+		for (auto const threads : {2, 3, 4, 7, 16, 0}) {
+			CHECK(bits(comp6771::reproducible_sum(a, threads)) == bits(sum));
+			CHECK(bits(comp6771::reproducible_dot(a, b, threads)) == bits(dot));
+			CHECK(bits(comp6771::reproducible_norm(a, threads)) == bits(norm));
+		}
+	}
+
+	SECTION("Agree with the ordinary reductions to rounding") {
+		CHECK(comp6771::reproducible_sum(a, 4) == Approx(a.sum()).margin(1e-3));
+		CHECK(comp6771::reproducible_dot(a, b, 4) == Approx(comp6771::dot(a, b)));
+		CHECK(comp6771::reproducible_norm(a, 4) == Approx(comp6771::euclidean_norm(a)));
+		CHECK(comp6771::reproducible_sum(comp6771::euclidean_vector{1, 2, 3}) == 6);
+		CHECK(comp6771::reproducible_dot(comp6771::euclidean_vector{1, 2},
+		                                 comp6771::euclidean_vector{3, 4})
+		      == 11);
+		CHECK(comp6771::reproducible_sum(comp6771::euclidean_vector(0)) == 0);
+	}
+
+	SECTION("Norm survives extreme magnitudes, reproducibly") {
+		auto const huge = comp6771::euclidean_vector(dimensions, 1e300);
+		auto const expected = 1e300 * std::sqrt(static_cast<double>(dimensions));
+		CHECK(comp6771::reproducible_norm(huge) == Approx(expected));
+		CHECK(bits(comp6771::reproducible_norm(huge, 5)) == bits(comp6771::reproducible_norm(huge)));
+		CHECK(comp6771::reproducible_norm(comp6771::euclidean_vector{3e-200, 4e-200})
+		      == Approx(5e-200));
+	}
+
+	SECTION("Errors") {
+		CHECK_THROWS_MATCHES(comp6771::reproducible_dot(comp6771::euclidean_vector(2),
+		                                                comp6771::euclidean_vector(3)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(3) do not match"));
+		CHECK_THROWS_MATCHES(comp6771::reproducible_norm(comp6771::euclidean_vector(0)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with no dimensions does not "
+		                                              "have a norm"));
+	}
+}
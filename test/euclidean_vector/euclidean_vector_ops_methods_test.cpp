@@ -1,9 +1,19 @@
 // tests euclidean vector class methods and operators
 #include "comp6771/euclidean_vector.hpp"
 
+#include <algorithm>
 #include <catch2/catch.hpp>
+#include <cstdint>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <range/v3/algorithm.hpp>
+#include <range/v3/range/concepts.hpp>
+#include <ranges>
+#include <utility>
+#include <vector>
 
 TEST_CASE("operator[] getting tests") {
 	SECTION("Single dimensional default vector") {
@@ -253,3 +263,330 @@ TEST_CASE("Vector conversion function") {
 		CHECK(vvector.empty());
 	}
 }
+
+TEST_CASE("Range interface") {
+	STATIC_REQUIRE(std::ranges::contiguous_range<comp6771::euclidean_vector>);
+	STATIC_REQUIRE(std::ranges::sized_range<comp6771::euclidean_vector>);
+	STATIC_REQUIRE(std::ranges::contiguous_range<comp6771::euclidean_vector const>);
+	STATIC_REQUIRE(std::contiguous_iterator<comp6771::euclidean_vector::iterator>);
+	STATIC_REQUIRE(ranges::contiguous_range<comp6771::euclidean_vector>);
+	STATIC_REQUIRE(ranges::sized_range<comp6771::euclidean_vector const>);
+	// writable access may detach copy-on-write storage, which allocates
+	STATIC_REQUIRE(noexcept(std::declval<comp6771::euclidean_vector const&>().data()));
+	STATIC_REQUIRE(not noexcept(std::declval<comp6771::euclidean_vector&>().data()));
+	STATIC_REQUIRE(not noexcept(std::declval<comp6771::euclidean_vector&>().begin()));
+
+	SECTION("Iterates over the magnitudes in place") {
+		auto const ev = comp6771::euclidean_vector{3, 1, 2};
+		CHECK(ev.size() == 3);
+		CHECK(*ev.data() == ev[0]);
+		CHECK(ev.end() - ev.begin() == 3);
+		CHECK(std::vector<double>(ev.begin(), ev.end()) == std::vector<double>{3, 1, 2});
+		CHECK(std::accumulate(ev.begin(), ev.end(), 0.0) == 6);
+		CHECK(*ranges::max_element(ev) == 3);
+		auto total = 0.0;
+		for (auto const magnitude : ev) {
+			total += magnitude;
+		}
+		CHECK(total == 6);
+	}
+
+	SECTION("Algorithms can write through the iterators") {
+		auto ev = comp6771::euclidean_vector{3, 1, 2};
+		std::ranges::sort(ev);
+		CHECK(ev == comp6771::euclidean_vector{1, 2, 3});
+		ranges::fill(ev, 7.0);
+		CHECK(ev == comp6771::euclidean_vector(3, 7.0));
+	}
+
+	SECTION("Data is aligned and empty vectors are empty ranges") {
+		auto const ev = comp6771::euclidean_vector(5);
+		CHECK(reinterpret_cast<std::uintptr_t>(ev.data()) % comp6771::euclidean_vector::storage_alignment
+		      == 0);
+		auto const empty = comp6771::euclidean_vector(0);
+		CHECK(empty.begin() == empty.end());
+		CHECK(std::ranges::empty(empty));
+	}
+
+	SECTION("Writable access detaches copy-on-write storage") {
+		auto ev = comp6771::euclidean_vector{1, 2, 3};
+		ev.share_on_copy(true);
+		auto const copy = ev;
+		CHECK(std::as_const(ev).data() == copy.data());
+		*ev.begin() = 10;
+		CHECK(ev.data() != copy.data());
+		CHECK(copy == comp6771::euclidean_vector{1, 2, 3});
+	}
+
+	SECTION("Range of a vector builds another vector") {
+		auto const ev = comp6771::euclidean_vector{1, 2, 3};
+		auto const doubled = comp6771::euclidean_vector(ev | std::views::transform([](double x) {
+			                                                return 2 * x;
+		                                                }));
+		CHECK(doubled == comp6771::euclidean_vector{2, 4, 6});
+	}
+}
+
+TEST_CASE("Fused in-place updates (axpy, axpby, lerp, fma)") {
+	SECTION("axpy adds a scaled vector") {
+		auto y = comp6771::euclidean_vector{1, 2, 3};
+		auto const x = comp6771::euclidean_vector{4, 3, 2};
+		y.axpy(2.0, x);
+		CHECK(fmt::format("{}", y) == "[9 8 7]");
+		CHECK(fmt::format("{}", x) == "[4 3 2]"); // source left untouched
+	}
+
+	SECTION("axpy matches the operator form") {
+		auto y = comp6771::euclidean_vector{1.5, -2, 0.25};
+		auto const x = comp6771::euclidean_vector{4, 3, 2};
+		auto expected = y + 0.5 * x;
+		CHECK(y.axpy(0.5, x) == expected);
+	}
+
+	SECTION("axpby scales both sides") {
+		auto y = comp6771::euclidean_vector{1, 2, 3};
+		auto const x = comp6771::euclidean_vector{4, 3, 2};
+		y.axpby(2.0, x, -1.0);
+		CHECK(fmt::format("{}", y) == "[7 4 1]");
+	}
+
+	SECTION("lerp end points and midpoint") {
+		auto const target = comp6771::euclidean_vector{4, 8};
+		auto y = comp6771::euclidean_vector{2, 4};
+		CHECK(fmt::format("{}", comp6771::euclidean_vector(y).lerp(target, 0.0)) == "[2 4]");
+		CHECK(fmt::format("{}", comp6771::euclidean_vector(y).lerp(target, 1.0)) == "[4 8]");
+		CHECK(fmt::format("{}", y.lerp(target, 0.5)) == "[3 6]");
+	}
+
+	SECTION("fma adds element-wise products") {
+		auto y = comp6771::euclidean_vector{1, 1, 1};
+		auto const a = comp6771::euclidean_vector{1, 2, 3};
+		auto const b = comp6771::euclidean_vector{4, 5, 6};
+		y.fma(a, b);
+		CHECK(fmt::format("{}", y) == "[5 11 19]");
+	}
+
+	SECTION("Zero-dimensional vectors") {
+		auto y = comp6771::euclidean_vector(0);
+		auto const x = comp6771::euclidean_vector(0);
+		y.axpy(3.0, x).axpby(1.0, x, 2.0).lerp(x, 0.5).fma(x, x);
+		CHECK(fmt::format("{}", y) == "[]");
+	}
+
+	SECTION("Mismatched dimensions throw") {
+		auto y = comp6771::euclidean_vector{1, 2};
+		auto const x = comp6771::euclidean_vector{1, 2, 3};
+		CHECK_THROWS_AS(y.axpy(1.0, x), comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(y.fma(y, x), comp6771::euclidean_vector_error);
+		CHECK(fmt::format("{}", y) == "[1 2]"); // unchanged on failure
+	}
+}
+
+TEST_CASE("Reductions") {
+	auto const ev = comp6771::euclidean_vector{2, -1, 7, 4, -1, 7, 3};
+
+	SECTION("Individual reductions") {
+		CHECK(ev.sum() == 21);
+		CHECK(ev.min() == -1);
+		CHECK(ev.max() == 7);
+		CHECK(ev.argmin() == 1); // first of the two -1s
+		CHECK(ev.argmax() == 2); // first of the two 7s
+		CHECK(ev.mean() == 3);
+		CHECK(ev.variance() == Approx(66.0 / 7));
+	}
+
+	SECTION("summarise() agrees with the individual reductions") {
+		auto const stats = ev.summarise();
+		CHECK(stats.sum == ev.sum());
+		CHECK(stats.min == ev.min());
+		CHECK(stats.max == ev.max());
+		CHECK(stats.argmin == ev.argmin());
+		CHECK(stats.argmax == ev.argmax());
+		CHECK(stats.mean == Approx(ev.mean()));
+		CHECK(stats.variance == Approx(ev.variance()));
+	}
+
+	SECTION("Threaded summarise() matches single-threaded") {
+		auto large = comp6771::euclidean_vector(100003);
+		for (auto i = 0; i < large.dimensions(); ++i) {
+			large[i] = 1e6 + static_cast<double>((i * 37) % 101); // large offset, small spread
+		}
+		large[70000] = -5; // unique minimum late in the vector
+		auto const single = large.summarise(1);
+		auto const threaded = large.summarise(4);
+		CHECK(threaded.argmin == 70000);
+		CHECK(single.argmin == 70000);
+		CHECK(threaded.argmax == single.argmax);
+		CHECK(threaded.max == single.max);
+		CHECK(threaded.mean == Approx(single.mean).epsilon(1e-12));
+		CHECK(threaded.variance == Approx(single.variance).epsilon(1e-9));
+	}
+
+	SECTION("Single and zero-dimensional vectors") {
+		auto const one = comp6771::euclidean_vector{5};
+		CHECK(one.summarise().variance == 0);
+		CHECK(one.argmax() == 0);
+		auto const empty = comp6771::euclidean_vector(0);
+		CHECK(empty.sum() == 0);
+		CHECK_THROWS_AS(empty.min(), comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(empty.summarise(), comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Element-wise transform, map and zip_with") {
+	SECTION("In-place transform with a lambda") {
+		auto ev = comp6771::euclidean_vector{1, 2, 3};
+		ev.transform([](double x) { return x * x + 1; });
+		CHECK(fmt::format("{}", ev) == "[2 5 10]");
+	}
+
+	SECTION("In-place zip with another vector") {
+		auto ev = comp6771::euclidean_vector{1, 2, 3};
+		auto const other = comp6771::euclidean_vector{4, 5, 6};
+		ev.transform(other, [](double x, double y) { return y - 2 * x; });
+		CHECK(fmt::format("{}", ev) == "[2 1 0]");
+	}
+
+	SECTION("Out-of-place map leaves the source alone") {
+		auto const ev = comp6771::euclidean_vector{-1.5, 0, 2};
+		auto const doubled = comp6771::map(ev, [](double x) { return 2 * x; });
+		CHECK(fmt::format("{}", doubled) == "[-3 0 4]");
+		CHECK(fmt::format("{}", ev) == "[-1.5 0 2]");
+	}
+
+	SECTION("Functions returning other arithmetic types") {
+		auto const ev = comp6771::euclidean_vector{1.7, -2.2};
+		auto const truncated = comp6771::map(ev, [](double x) { return static_cast<int>(x); });
+		CHECK(fmt::format("{}", truncated) == "[1 -2]");
+	}
+
+	SECTION("Built-in helpers") {
+		auto const a = comp6771::euclidean_vector{-1, 2, -3};
+		auto const b = comp6771::euclidean_vector{4, 5, 6};
+		CHECK(fmt::format("{}", comp6771::hadamard(a, b)) == "[-4 10 -18]");
+		CHECK(fmt::format("{}", comp6771::abs(a)) == "[1 2 3]");
+		CHECK(fmt::format("{}", comp6771::clamp(b, 4.5, 5.5)) == "[4.5 5 5.5]");
+	}
+
+	SECTION("Zero-dimensional and mismatched vectors") {
+		auto const empty = comp6771::euclidean_vector(0);
+		CHECK(comp6771::map(empty, [](double x) { return x + 1; }).dimensions() == 0);
+		CHECK_THROWS_AS(comp6771::hadamard(empty, comp6771::euclidean_vector{1}),
+		                comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Unchecked fast paths") {
+	auto const x = comp6771::euclidean_vector{1, 2, 3, 4, 5};
+
+	SECTION("Same results as the checked operations") {
+		auto y = comp6771::euclidean_vector{5, 4, 3, 2, 1};
+		y.add(x, comp6771::unchecked);
+		CHECK(y == comp6771::euclidean_vector{6, 6, 6, 6, 6});
+		y.subtract(x, comp6771::unchecked);
+		CHECK(y == comp6771::euclidean_vector{5, 4, 3, 2, 1});
+		y.axpy(2, x, comp6771::unchecked);
+		CHECK(y == comp6771::euclidean_vector{7, 8, 9, 10, 11});
+		y.divide(2, comp6771::unchecked);
+		CHECK(y == comp6771::euclidean_vector{3.5, 4, 4.5, 5, 5.5});
+		CHECK(comp6771::dot(x, x, comp6771::unchecked) == 55);
+		CHECK(comp6771::dot(comp6771::euclidean_vector(0), comp6771::euclidean_vector(0), comp6771::unchecked)
+		      == 0);
+	}
+
+	SECTION("Declared noexcept") {
+		auto y = comp6771::euclidean_vector(5);
+		STATIC_REQUIRE(noexcept(y.add(x, comp6771::unchecked)));
+		STATIC_REQUIRE(noexcept(y.subtract(x, comp6771::unchecked)));
+		STATIC_REQUIRE(noexcept(y.axpy(1.0, x, comp6771::unchecked)));
+		STATIC_REQUIRE(noexcept(y.divide(1.0, comp6771::unchecked)));
+		STATIC_REQUIRE(noexcept(comp6771::dot(x, y, comp6771::unchecked)));
+	}
+
+	SECTION("Division by zero follows double arithmetic instead of throwing") {
+		auto y = comp6771::euclidean_vector{1, -1};
+		y.divide(0, comp6771::unchecked);
+		CHECK(y[0] == std::numeric_limits<double>::infinity());
+		CHECK(y[1] == -std::numeric_limits<double>::infinity());
+	}
+
+	SECTION("Copy-on-write copies are detached by data() first") {
+		auto y = comp6771::euclidean_vector{1, 1, 1, 1, 1};
+		y.share_on_copy(true);
+		auto const copy = y;
+		static_cast<void>(y.data());
+		REQUIRE(not y.shares_storage_with(copy));
+		y.add(x, comp6771::unchecked);
+		CHECK(y == comp6771::euclidean_vector{2, 3, 4, 5, 6});
+		CHECK(copy == comp6771::euclidean_vector{1, 1, 1, 1, 1});
+	}
+}
+
+TEST_CASE("In-place and batched normalisation") {
+	SECTION("normalise() gives exactly unit()") {
+		auto ev = comp6771::euclidean_vector{2.2, -3.3, 4.4};
+		auto const expected = comp6771::unit(ev);
+		auto const* const storage = ev.data();
+		CHECK(ev.normalise() == expected);
+		CHECK(std::as_const(ev).data() == storage);
+
+		auto huge = comp6771::euclidean_vector{3e200, 4e200};
+		auto const huge_unit = comp6771::unit(huge);
+		CHECK(huge.normalise() == huge_unit);
+		CHECK(huge[0] == Approx(0.6));
+	}
+
+	SECTION("normalise() throws like unit()") {
+		auto empty = comp6771::euclidean_vector(0);
+		CHECK_THROWS_MATCHES(empty.normalise(),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with no dimensions does not "
+		                                              "have a unit vector"));
+		auto zero = comp6771::euclidean_vector(3);
+		CHECK_THROWS_MATCHES(zero.normalise(),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal "
+		                                              "does not have a unit vector"));
+	}
+
+	SECTION("Batches report the vectors they couldn't normalise") {
+		for (auto const threads : {1, 2, 3, 0}) {
+			auto batch = std::vector<comp6771::euclidean_vector>();
+			for (auto i = 0; i < 50; ++i) {
+				batch.push_back(i % 7 == 3 ? comp6771::euclidean_vector(4)
+				                           : comp6771::euclidean_vector{1.0 * i, 2, 3, 4});
+			}
+			batch.push_back(comp6771::euclidean_vector(0));
+			auto const original = batch;
+
+			auto const skipped = comp6771::normalise(batch, threads);
+			CHECK(skipped == std::vector<std::size_t>{3, 10, 17, 24, 31, 38, 45, 50});
+			for (auto i = std::size_t{0}; i < batch.size(); ++i) {
+				if (std::find(skipped.begin(), skipped.end(), i) == skipped.end()) {
+					CHECK(batch[i] == comp6771::unit(original[i]));
+				}
+				else {
+					CHECK(batch[i] == original[i]);
+				}
+			}
+		}
+		auto none = std::vector<comp6771::euclidean_vector>();
+		CHECK(comp6771::normalise(none, 4).empty());
+	}
+
+	SECTION("Batches leave vectors they share storage with unchanged") {
+		auto source = comp6771::euclidean_vector{3, 4};
+		source.share_on_copy(true);
+		for (auto const threads : {1, 2}) {
+			auto batch = std::vector<comp6771::euclidean_vector>(3, source);
+			REQUIRE(batch[0].shares_storage_with(source));
+
+			CHECK(comp6771::normalise(batch, threads).empty());
+			for (auto const& v : batch) {
+				CHECK(v == comp6771::euclidean_vector{0.6, 0.8});
+				CHECK(not v.shares_storage_with(source));
+			}
+			CHECK(source == comp6771::euclidean_vector{3, 4});
+		}
+	}
+}
@@ -0,0 +1,90 @@
+// tests the coroutine streaming pipeline (read -> normalise -> score -> write)
+#include "comp6771/euclidean_vector_pipeline.hpp"
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("read_vectors stage") {
+	SECTION("One vector per line, blank lines skipped") {
+		auto in = std::istringstream("1 2 3\n\n4.5 6\n");
+		auto read = std::vector<comp6771::euclidean_vector>();
+		for (auto& ev : comp6771::read_vectors(in)) {
+			read.push_back(std::move(ev));
+		}
+		REQUIRE(read.size() == 2);
+		CHECK(fmt::format("{}", read[0]) == "[1 2 3]");
+		CHECK(fmt::format("{}", read[1]) == "[4.5 6]");
+	}
+
+	SECTION("Bad input is reported to the consumer") {
+		auto in = std::istringstream("1 2\n3 x 4\n");
+		auto vectors = comp6771::read_vectors(in);
+		auto it = vectors.begin(); // first line is fine
+		CHECK(fmt::format("{}", *it) == "[1 2]");
+		CHECK_THROWS_AS(++it, comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Full pipeline") {
+	auto const query = comp6771::euclidean_vector{1, 0};
+
+	SECTION("Normalise and score every line") {
+		auto in = std::istringstream("3 4\n0 2\n5 0\n");
+		auto out = std::ostringstream();
+		auto const written =
+		   comp6771::write_scores(comp6771::score(comp6771::normalise(comp6771::read_vectors(in)),
+		                                          query),
+		                          out);
+		CHECK(written == 3);
+		CHECK(out.str() == "0.6\n0\n1\n");
+	}
+
+	SECTION("Same output with a prefetching reader thread") {
+		auto in = std::istringstream("3 4\n0 2\n5 0\n");
+		auto out = std::ostringstream();
+		auto const written = comp6771::write_scores(
+		   comp6771::score(comp6771::normalise(comp6771::prefetch(comp6771::read_vectors(in), 2)),
+		                   query),
+		   out);
+		CHECK(written == 3);
+		CHECK(out.str() == "0.6\n0\n1\n");
+	}
+
+	SECTION("Large input streams through a small prefetch buffer") {
+		auto text = std::string();
+		for (auto i = 1; i <= 1000; ++i) {
+			text += std::to_string(i) + " 0\n";
+		}
+		auto in = std::istringstream(text);
+		auto out = std::ostringstream();
+		auto const written = comp6771::write_scores(
+		   comp6771::score(comp6771::normalise(comp6771::prefetch(comp6771::read_vectors(in), 4)),
+		                   query),
+		   out);
+		CHECK(written == 1000);
+	}
+
+	SECTION("Errors from the worker thread reach the consumer") {
+		auto in = std::istringstream("1 0\n0 0\n");
+		auto out = std::ostringstream();
+		// the zero vector has no unit vector
+		CHECK_THROWS_AS(comp6771::write_scores(
+		                   comp6771::score(comp6771::prefetch(comp6771::normalise(
+		                                                         comp6771::read_vectors(in)),
+		                                                      1),
+		                                   query),
+		                   out),
+		                comp6771::euclidean_vector_error);
+	}
+
+	SECTION("Stopping early releases the worker") {
+		auto in = std::istringstream("1 0\n2 0\n3 0\n4 0\n");
+		auto vectors = comp6771::prefetch(comp6771::read_vectors(in), 1);
+		auto it = vectors.begin();
+		CHECK(fmt::format("{}", *it) == "[1 0]");
+		// vectors goes out of scope here, with the worker blocked on a full buffer
+	}
+}
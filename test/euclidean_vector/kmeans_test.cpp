@@ -0,0 +1,180 @@
+// tests k-means clustering: seeding, Lloyd and mini-batch iterations, threading and errors
+#include "comp6771/kmeans.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+	constexpr auto points_per_blob = 200;
+
+	// three tight, well separated blobs in the plane: points 0-199 around the first centre,
+	// 200-399 around the second, 400-599 around the third
+	auto make_blobs() -> comp6771::euclidean_matrix {
+		constexpr double centres[3][2] = {{0, 0}, {10, 10}, {-10, 10}};
+		auto engine = std::mt19937_64(42);
+		auto jitter = std::normal_distribution<double>(0.0, 0.5);
+		auto points = comp6771::euclidean_matrix(3 * points_per_blob, 2);
+		for (auto i = 0; i < points.rows(); ++i) {
+			points(i, 0) = centres[i / points_per_blob][0] + jitter(engine);
+			points(i, 1) = centres[i / points_per_blob][1] + jitter(engine);
+		}
+		return points;
+	}
+
+	// every blob in one cluster of its own
+	auto separates_blobs(std::vector<int> const& assignments) -> bool {
+		auto clusters = std::set<int>();
+		for (auto blob = 0; blob < 3; ++blob) {
+			auto const first = assignments.begin() + blob * points_per_blob;
+			if (not std::all_of(first, first + points_per_blob, [&](int c) { return c == *first; })) {
+				return false;
+			}
+			clusters.insert(*first);
+		}
+		return clusters.size() == 3;
+	}
+
+	auto inertia_of(comp6771::euclidean_matrix const& points, comp6771::kmeans_result const& result)
+	   -> double {
+		auto inertia = 0.0;
+		for (auto i = 0; i < points.rows(); ++i) {
+			auto const c = result.assignments[static_cast<std::size_t>(i)];
+			for (auto d = 0; d < points.columns(); ++d) {
+				auto const difference = points(i, d) - result.centroids(c, d);
+				inertia += difference * difference;
+			}
+		}
+		return inertia;
+	}
+} // namespace
+
+TEST_CASE("Lloyd iterations find well separated clusters") {
+	auto const points = make_blobs();
+	auto const result = comp6771::kmeans(points, {.clusters = 3, .seed = 7});
+
+	CHECK(result.converged);
+	CHECK(result.iterations >= 1);
+	CHECK(result.iterations < 100);
+	CHECK(result.centroids.rows() == 3);
+	CHECK(result.centroids.columns() == 2);
+	REQUIRE(result.assignments.size() == 600);
+	CHECK(separates_blobs(result.assignments));
+	CHECK(result.inertia == Approx(inertia_of(points, result)));
+
+	// each centroid is the mean of its blob
+	for (auto blob = 0; blob < 3; ++blob) {
+		auto const c = result.assignments[static_cast<std::size_t>(blob * points_per_blob)];
+		auto mean = std::vector<double>(2);
+		for (auto i = blob * points_per_blob; i < (blob + 1) * points_per_blob; ++i) {
+			mean[0] += points(i, 0) / points_per_blob;
+			mean[1] += points(i, 1) / points_per_blob;
+		}
+		CHECK(result.centroids(c, 0) == Approx(mean[0]));
+		CHECK(result.centroids(c, 1) == Approx(mean[1]));
+	}
+}
+
+TEST_CASE("k-means is deterministic for a seed") {
+	auto const points = make_blobs();
+	auto const first = comp6771::kmeans(points, {.clusters = 5, .seed = 3});
+	auto const second = comp6771::kmeans(points, {.clusters = 5, .seed = 3});
+	CHECK(first.assignments == second.assignments);
+	CHECK(first.centroids == second.centroids);
+	CHECK(first.inertia == second.inertia);
+	CHECK(first.iterations == second.iterations);
+
+	// the same with any standard library: these picks only depend on mt19937_64's output
+	auto squares = comp6771::euclidean_matrix(10, 1);
+	for (auto i = 0; i < squares.rows(); ++i) {
+		squares(i, 0) = i * i;
+	}
+	auto const seeded = comp6771::kmeans(squares, {.clusters = 3, .max_iterations = 0, .seed = 6771});
+	CHECK(seeded.centroids == comp6771::euclidean_matrix(3, 1, {25, 81, 1}));
+}
+
+TEST_CASE("Multi-threaded k-means matches single-threaded") {
+	auto const points = make_blobs();
+	auto const single = comp6771::kmeans(points, {.clusters = 4, .seed = 11, .threads = 1});
+	for (auto const threads : {2, 3, 8}) {
+		auto const multi = comp6771::kmeans(points, {.clusters = 4, .seed = 11, .threads = threads});
+		CHECK(multi.assignments == single.assignments);
+		CHECK(multi.iterations == single.iterations);
+		CHECK(multi.inertia == Approx(single.inertia));
+		for (auto c = 0; c < 4; ++c) {
+			CHECK(multi.centroids(c, 0) == Approx(single.centroids(c, 0)));
+			CHECK(multi.centroids(c, 1) == Approx(single.centroids(c, 1)));
+		}
+	}
+}
+
+TEST_CASE("Mini-batch k-means") {
+	auto const points = make_blobs();
+	auto const result = comp6771::kmeans(
+	   points,
+	   {.clusters = 3, .max_iterations = 50, .tolerance = 0.0, .batch_size = 64, .seed = 5, .threads = 2});
+	CHECK(result.iterations == 50);
+	CHECK(not result.converged);
+	REQUIRE(result.assignments.size() == 600);
+	CHECK(separates_blobs(result.assignments));
+	// the final assignment pass uses the final centroids
+	CHECK(result.inertia == Approx(inertia_of(points, result)));
+
+	// close to the Lloyd solution, if not exactly on it
+	auto const lloyd = comp6771::kmeans(points, {.clusters = 3, .seed = 5});
+	CHECK(result.inertia < 1.1 * lloyd.inertia);
+}
+
+TEST_CASE("k-means edge cases") {
+	SECTION("As many clusters as points") {
+		auto const points = comp6771::euclidean_matrix(4, 2, {0, 0, 1, 0, 0, 1, 5, 5});
+		auto const result = comp6771::kmeans(points, {.clusters = 4});
+		CHECK(result.inertia == 0.0);
+		CHECK(std::set<int>(result.assignments.begin(), result.assignments.end()).size() == 4);
+	}
+	SECTION("Fewer distinct points than clusters") {
+		auto const points = comp6771::euclidean_matrix(5, 3, 1.5);
+		auto const result = comp6771::kmeans(points, {.clusters = 2});
+		CHECK(result.inertia == 0.0);
+		CHECK(result.converged);
+	}
+	SECTION("No iterations leaves the k-means++ centroids") {
+		auto const points = make_blobs();
+		auto const result = comp6771::kmeans(points, {.clusters = 3, .max_iterations = 0});
+		CHECK(result.iterations == 0);
+		CHECK(not result.converged);
+		CHECK(result.inertia == Approx(inertia_of(points, result)));
+	}
+	SECTION("Points as separate vectors") {
+		auto const vectors = std::vector<comp6771::euclidean_vector>{{0, 0}, {0, 1}, {9, 9}, {9, 10}};
+		auto const result = comp6771::kmeans(vectors, {.clusters = 2, .seed = 1});
+		CHECK(result.assignments[0] == result.assignments[1]);
+		CHECK(result.assignments[2] == result.assignments[3]);
+		CHECK(result.assignments[0] != result.assignments[2]);
+		CHECK(result.inertia == Approx(1.0));
+	}
+}
+
+TEST_CASE("k-means errors") {
+	auto const points = comp6771::euclidean_matrix(3, 2, 1.0);
+	CHECK_THROWS_MATCHES(comp6771::kmeans(points, {.clusters = 0}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot make 0 clusters from 3 points"));
+	CHECK_THROWS_MATCHES(comp6771::kmeans(points, {.clusters = 4}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot make 4 clusters from 3 points"));
+	CHECK_THROWS_MATCHES(comp6771::kmeans(points, {.clusters = 2, .max_iterations = -1}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("max_iterations cannot be negative"));
+	CHECK_THROWS_MATCHES(comp6771::kmeans(comp6771::euclidean_matrix(3, 0), {.clusters = 1}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Points with no dimensions cannot be clustered"));
+
+	auto const mismatched = std::vector<comp6771::euclidean_vector>{{0, 0}, {1, 1, 1}};
+	CHECK_THROWS_AS(comp6771::kmeans(mismatched, {.clusters = 1}), comp6771::euclidean_vector_error);
+}
@@ -0,0 +1,205 @@
+// tests .npy reading and writing
+#include "comp6771/npy.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	// a file in the temporary directory, removed again when the test is done with it
+	class temporary_file {
+	public:
+		explicit temporary_file(std::string const& name)
+		: path_((std::filesystem::temp_directory_path() / ("comp6771_npy_test_" + name)).string()) {}
+		temporary_file(temporary_file const&) = delete;
+		auto operator=(temporary_file const&) -> temporary_file& = delete;
+		~temporary_file() {
+			std::filesystem::remove(path_);
+		}
+
+		[[nodiscard]] auto path() const -> std::string const& { return path_; }
+
+		auto write(std::string const& bytes) const -> void {
+			auto out = std::ofstream(path_, std::ios::binary);
+			out << bytes;
+		}
+		[[nodiscard]] auto read() const -> std::string {
+			auto in = std::ifstream(path_, std::ios::binary);
+			return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+
+	private:
+		std::string path_;
+	};
+
+	// a file laid out the way numpy.save does it, from the header dict and raw values
+	template<typename T>
+	auto npy_bytes(std::string dict, std::vector<T> const& values, char const major_version = 1) -> std::string {
+		auto const preamble = major_version == 1 ? std::size_t{10} : std::size_t{12};
+		auto const total = (preamble + dict.size() + 1 + 63) / 64 * 64;
+		dict.resize(total - preamble - 1, ' ');
+		dict.push_back('\n');
+
+		auto bytes = std::string("\x93NUMPY", 6);
+		bytes.push_back(major_version);
+		bytes.push_back('\0');
+		for (auto i = std::size_t{0}; i < preamble - 8; ++i) {
+			bytes.push_back(static_cast<char>((dict.size() >> (8 * i)) & 0xff));
+		}
+		bytes += dict;
+		auto raw = std::string(values.size() * sizeof(T), '\0');
+		if (not values.empty()) { // data() may be null for an empty vector
+			std::memcpy(raw.data(), values.data(), raw.size());
+		}
+		return bytes + raw;
+	}
+} // namespace
+
+TEST_CASE("Writing and reading back float64") {
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {-4.5, 5e-300, 6e300}};
+
+	SECTION("One vector") {
+		auto const file = temporary_file("vector.npy");
+		{
+			auto out = std::ofstream(file.path(), std::ios::binary);
+			comp6771::write_npy(out, vectors[1]);
+		}
+		auto const npy = comp6771::npy_file(file.path());
+		CHECK(npy.dtype() == comp6771::npy_dtype::float64);
+		CHECK(npy.rank() == 1);
+		CHECK(npy.rows() == 1);
+		CHECK(npy.columns() == 3);
+		CHECK(npy.row_vector(0) == vectors[1]);
+		CHECK(npy.values().size() == 3);
+		CHECK(npy.values()[2] == 6e300);
+	}
+
+	SECTION("Vectors and matrices") {
+		auto const from_vectors = temporary_file("vectors.npy");
+		auto const from_matrix = temporary_file("matrix.npy");
+		{
+			auto out = std::ofstream(from_vectors.path(), std::ios::binary);
+			comp6771::write_npy(out, vectors);
+			auto matrix_out = std::ofstream(from_matrix.path(), std::ios::binary);
+			comp6771::write_npy(matrix_out, comp6771::euclidean_matrix(vectors));
+		}
+		// the same array either way
+		CHECK(from_vectors.read() == from_matrix.read());
+
+		auto const npy = comp6771::npy_file(from_matrix.path());
+		CHECK(npy.rank() == 2);
+		CHECK(npy.rows() == 2);
+		CHECK(npy.columns() == 3);
+		CHECK(npy.to_vectors() == vectors);
+		CHECK(npy.to_matrix() == comp6771::euclidean_matrix(vectors));
+		CHECK(npy.row(1)[0] == -4.5);
+		CHECK(npy.row(1).data() == npy.values().data() + 3); // views into the one mapping
+		CHECK_THROWS_MATCHES(npy.float_values(),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("npy_file holds float64 values, not float32"));
+	}
+
+	SECTION("The header is what numpy writes") {
+		auto out = std::ostringstream();
+		comp6771::write_npy(out, std::span<comp6771::euclidean_vector const>(vectors));
+		CHECK(out.str() == npy_bytes("{'descr': '<f8', 'fortran_order': False, 'shape': (2, 3), }",
+		                             std::vector<double>{1, 2, 3, -4.5, 5e-300, 6e300}));
+	}
+}
+
+TEST_CASE("Writing and reading back float32") {
+	auto const v = comp6771::euclidean_vector{0.1, 0.2, 1e-3};
+	auto const file = temporary_file("float32.npy");
+	{
+		auto out = std::ofstream(file.path(), std::ios::binary);
+		comp6771::write_npy(out, v, comp6771::npy_dtype::float32);
+	}
+	auto const npy = comp6771::npy_file(file.path());
+	CHECK(npy.dtype() == comp6771::npy_dtype::float32);
+	REQUIRE(npy.float_values().size() == 3);
+	CHECK(npy.float_values()[0] == 0.1F);
+	CHECK(npy.row_vector(0) == comp6771::euclidean_vector{0.1F, 0.2F, 1e-3F});
+	CHECK(npy.to_matrix().row_vector(0) == npy.row_vector(0));
+	CHECK_THROWS_AS(npy.values(), comp6771::euclidean_vector_error);
+}
+
+TEST_CASE("Reading files numpy wrote") {
+	auto const file = temporary_file("numpy.npy");
+
+	SECTION("2-D float32") {
+		file.write(npy_bytes("{'descr': '<f4', 'fortran_order': False, 'shape': (2, 2), }",
+		                     std::vector<float>{1, 2, 3, 4}));
+		auto const npy = comp6771::npy_file(file.path());
+		CHECK(npy.to_vectors() == std::vector<comp6771::euclidean_vector>{{1, 2}, {3, 4}});
+	}
+	SECTION("Version 2.0 header") {
+		file.write(npy_bytes("{'descr': '<f8', 'fortran_order': False, 'shape': (4,), }",
+		                     std::vector<double>{1, 2, 3, 4},
+		                     2));
+		CHECK(comp6771::npy_file(file.path()).row_vector(0) == comp6771::euclidean_vector{1, 2, 3, 4});
+	}
+	SECTION("Empty array") {
+		file.write(npy_bytes("{'descr': '<f8', 'fortran_order': False, 'shape': (0, 5), }",
+		                     std::vector<double>{}));
+		auto const npy = comp6771::npy_file(file.path());
+		CHECK(npy.rows() == 0);
+		CHECK(npy.columns() == 5);
+		CHECK(npy.to_vectors().empty());
+	}
+	SECTION("Moving keeps the mapping") {
+		file.write(npy_bytes("{'descr': '<f8', 'fortran_order': False, 'shape': (2,), }",
+		                     std::vector<double>{7, 8}));
+		auto npy = comp6771::npy_file(file.path());
+		auto const moved = std::move(npy);
+		CHECK(moved.row_vector(0) == comp6771::euclidean_vector{7, 8});
+	}
+}
+
+TEST_CASE("Unreadable files throw") {
+	auto const file = temporary_file("bad.npy");
+	auto const message = [&](std::string const& what) { return Catch::Matchers::Message(file.path() + ": " + what); };
+
+	CHECK_THROWS_MATCHES(comp6771::npy_file(file.path() + ".missing"),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message(file.path() + ".missing: could not open file"));
+
+	file.write("1 2 3\n");
+	CHECK_THROWS_MATCHES(comp6771::npy_file(file.path()), comp6771::euclidean_vector_error, message("not a .npy file"));
+
+	file.write(npy_bytes("{'descr': '>f8', 'fortran_order': False, 'shape': (2,), }", std::vector<double>{1, 2}));
+	CHECK_THROWS_MATCHES(comp6771::npy_file(file.path()),
+	                     comp6771::euclidean_vector_error,
+	                     message("unsupported dtype '>f8' (only little-endian float64 and float32 are)"));
+
+	file.write(npy_bytes("{'descr': '<f8', 'fortran_order': True, 'shape': (1, 2), }", std::vector<double>{1, 2}));
+	CHECK_THROWS_MATCHES(comp6771::npy_file(file.path()),
+	                     comp6771::euclidean_vector_error,
+	                     message("only C-order arrays are supported"));
+
+	file.write(npy_bytes("{'descr': '<f8', 'fortran_order': False, 'shape': (1, 1, 2), }", std::vector<double>{1, 2}));
+	CHECK_THROWS_MATCHES(comp6771::npy_file(file.path()),
+	                     comp6771::euclidean_vector_error,
+	                     message("only 1-D and 2-D arrays are supported, not 3-D"));
+
+	file.write(npy_bytes("{'descr': '<f8', 'fortran_order': False, 'shape': (2, 2), }", std::vector<double>{1, 2, 3}));
+	CHECK_THROWS_MATCHES(comp6771::npy_file(file.path()),
+	                     comp6771::euclidean_vector_error,
+	                     message("file is shorter than its array"));
+}
+
+TEST_CASE("Writing vectors of different dimensions throws") {
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {1, 2}};
+	auto out = std::ostringstream();
+	CHECK_THROWS_MATCHES(comp6771::write_npy(out, vectors),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of npy rows (3 and 2) do not match"));
+	CHECK(out.str().empty());
+}
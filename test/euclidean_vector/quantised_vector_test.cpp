@@ -0,0 +1,86 @@
+// tests int8 quantisation: encode/decode round trips, approximate dot/distance and reranking
+#include "comp6771/quantised_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <vector>
+
+TEST_CASE("Encoding and decoding") {
+	SECTION("Values on the code grid round trip exactly") {
+		auto const ev = comp6771::euclidean_vector{-127, 0, 1, 127};
+		auto const q = comp6771::quantised_vector(ev);
+		CHECK(q.dimensions() == 4);
+		CHECK(q.scale() == 1.0);
+		CHECK(q.offset() == 0.0);
+		CHECK(q.decode() == ev);
+	}
+
+	SECTION("Error is at most half a step of the scale") {
+		auto const ev = comp6771::euclidean_vector{0.1, 3.7, -2.25, 9.9, 4.0};
+		auto const q = comp6771::quantised_vector(ev);
+		auto const decoded = q.decode();
+		for (auto i = 0; i < ev.dimensions(); ++i) {
+			CHECK(std::abs(decoded[i] - ev[i]) <= q.scale() / 2 + 1e-12);
+		}
+	}
+
+	SECTION("Constant and empty vectors") {
+		auto const constant = comp6771::euclidean_vector(3, 2.5);
+		CHECK(comp6771::quantised_vector(constant).decode() == constant);
+		auto const empty = comp6771::euclidean_vector(0);
+		CHECK(comp6771::quantised_vector(empty).decode() == empty);
+	}
+
+	SECTION("Codes use one byte per dimension") {
+		auto const q = comp6771::quantised_vector(comp6771::euclidean_vector(1000, 1.0));
+		CHECK(q.codes().size_bytes() == 1000);
+	}
+}
+
+TEST_CASE("Approximate dot and distance") {
+	auto const a = comp6771::euclidean_vector{1.0, -2.0, 3.5, 0.25, 7.0};
+	auto const b = comp6771::euclidean_vector{-0.5, 4.0, 2.0, 1.0, -3.0};
+	auto const qa = comp6771::quantised_vector(a);
+	auto const qb = comp6771::quantised_vector(b);
+
+	SECTION("Dot matches the exact dot of the decoded vectors") {
+		CHECK(comp6771::approximate_dot(qa, qb)
+		      == Approx(comp6771::dot(qa.decode(), qb.decode())).epsilon(1e-12));
+	}
+
+	SECTION("Dot is close to the exact dot of the originals") {
+		CHECK(comp6771::approximate_dot(qa, qb) == Approx(comp6771::dot(a, b)).margin(0.2));
+	}
+
+	SECTION("Distance matches the decoded distance") {
+		auto const expected = comp6771::euclidean_norm(qa.decode() - qb.decode());
+		CHECK(comp6771::approximate_distance(qa, qb) == Approx(expected).epsilon(1e-9));
+		CHECK(comp6771::approximate_distance(qa, qa) == Approx(0.0).margin(1e-6));
+	}
+
+	SECTION("Mismatched dimensions throw") {
+		auto const qc = comp6771::quantised_vector(comp6771::euclidean_vector{1, 2});
+		CHECK_THROWS_AS(comp6771::approximate_dot(qa, qc), comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Reranking candidates with exact scores") {
+	auto const corpus = std::vector<comp6771::euclidean_vector>{{1, 0}, {0, 1}, {3, 0}, {2, 0}};
+	auto const query = comp6771::euclidean_vector{1, 0};
+
+	SECTION("Best k of the candidates, highest score first") {
+		auto const candidates = std::vector<std::size_t>{0, 1, 3};
+		auto const best = comp6771::rerank(query, corpus, candidates, 2);
+		REQUIRE(best.size() == 2);
+		CHECK(best[0].index == 3);
+		CHECK(best[0].score == 2.0);
+		CHECK(best[1].index == 0);
+	}
+
+	SECTION("k larger than the candidate list") {
+		auto const candidates = std::vector<std::size_t>{2};
+		CHECK(comp6771::rerank(query, corpus, candidates, 5).size() == 1);
+	}
+}
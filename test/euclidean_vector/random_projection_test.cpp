@@ -0,0 +1,141 @@
+// tests Johnson-Lindenstrauss random projections
+#include "comp6771/random_projection.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <random>
+#include <vector>
+
+namespace {
+	auto random_vectors(std::size_t const count, int const dimensions, unsigned const seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto distribution = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto result = std::vector<comp6771::euclidean_vector>();
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			auto& ev = result.emplace_back(dimensions);
+			for (auto& magnitude : ev) {
+				magnitude = distribution(engine);
+			}
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("Projection matrices") {
+	SECTION("Shape and accessors") {
+		auto const projection = comp6771::random_projection(100, 8, comp6771::projection_kind::sparse, 9);
+		CHECK(projection.input_dimensions() == 100);
+		CHECK(projection.output_dimensions() == 8);
+		CHECK(projection.kind() == comp6771::projection_kind::sparse);
+		CHECK(projection.seed() == 9);
+		CHECK(projection.matrix().rows() == 8);
+		CHECK(projection.matrix().columns() == 100);
+	}
+	SECTION("A seed always gives the same matrix") {
+		for (auto const kind : {comp6771::projection_kind::gaussian, comp6771::projection_kind::sparse}) {
+			auto const a = comp6771::random_projection(50, 10, kind, 1);
+			auto const b = comp6771::random_projection(50, 10, kind, 1);
+			auto const c = comp6771::random_projection(50, 10, kind, 2);
+			CHECK(a.matrix() == b.matrix());
+			CHECK(not(a.matrix() == c.matrix()));
+		}
+	}
+	SECTION("Gaussian entries have variance 1 / output") {
+		auto const projection = comp6771::random_projection(1000, 100);
+		auto sum = 0.0;
+		auto sum_of_squares = 0.0;
+		for (auto r = 0; r < 100; ++r) {
+			for (auto const entry : projection.matrix().row(r)) {
+				sum += entry;
+				sum_of_squares += entry * entry;
+			}
+		}
+		CHECK(sum / 100'000 == Approx(0.0).margin(0.002));
+		CHECK(sum_of_squares / 100'000 == Approx(1.0 / 100).epsilon(0.02));
+	}
+	SECTION("Achlioptas entries are 0 or +-sqrt(3 / output)") {
+		auto const projection = comp6771::random_projection(1000, 12, comp6771::projection_kind::sparse);
+		auto const scale = std::sqrt(3.0 / 12);
+		auto zeros = 0;
+		auto positive = 0;
+		auto negative = 0;
+		for (auto r = 0; r < 12; ++r) {
+			for (auto const entry : projection.matrix().row(r)) {
+				zeros += entry == 0.0;
+				positive += entry == scale;
+				negative += entry == -scale;
+			}
+		}
+		CHECK(zeros + positive + negative == 12'000);
+		CHECK(zeros / 12'000.0 == Approx(2.0 / 3).margin(0.02));
+		CHECK(positive / 12'000.0 == Approx(1.0 / 6).margin(0.02));
+		CHECK(negative / 12'000.0 == Approx(1.0 / 6).margin(0.02));
+	}
+}
+
+TEST_CASE("Projecting vectors and batches") {
+	auto const projection = comp6771::random_projection(300, 20, comp6771::projection_kind::gaussian, 4);
+	auto const vectors = random_vectors(7, 300, 1);
+
+	auto const single = projection(vectors[0]);
+	CHECK(single.dimensions() == 20);
+	CHECK(single == projection.matrix() * vectors[0]);
+
+	auto const batch = projection(vectors, 3);
+	REQUIRE(batch.size() == vectors.size());
+	auto const batch_matrix = projection(comp6771::euclidean_matrix(vectors), 2);
+	for (auto i = std::size_t{0}; i < vectors.size(); ++i) {
+		auto const expected = projection(vectors[i]);
+		REQUIRE(batch[i].dimensions() == 20);
+		for (auto d = 0; d < 20; ++d) {
+			CHECK(batch[i][d] == Approx(expected[d]));
+			CHECK(batch_matrix(static_cast<int>(i), d) == Approx(expected[d]));
+		}
+	}
+	CHECK(projection(std::vector<comp6771::euclidean_vector>()).empty());
+
+	CHECK_THROWS_MATCHES(
+	   projection(comp6771::euclidean_vector(299)),
+	   comp6771::euclidean_vector_error,
+	   Catch::Matchers::Message("Dimensions of matrix columns and euclidean_vector (300 and 299) do not match"));
+	CHECK_THROWS_AS(projection(comp6771::euclidean_matrix(2, 301)), comp6771::euclidean_vector_error);
+}
+
+TEST_CASE("Projections preserve distances") {
+	constexpr auto points = std::size_t{40};
+	constexpr auto epsilon = 0.3;
+	auto const output = comp6771::target_dimensions(points, epsilon);
+	auto const vectors = random_vectors(points, 4000, 2);
+	for (auto const kind : {comp6771::projection_kind::gaussian, comp6771::projection_kind::sparse}) {
+		auto const projection = comp6771::random_projection(4000, output, kind, 17);
+		auto const projected = projection(vectors, 2);
+		for (auto i = std::size_t{0}; i < points; ++i) {
+			for (auto j = i + 1; j < points; ++j) {
+				auto const before = comp6771::euclidean_norm(vectors[i] - vectors[j]);
+				auto const after = comp6771::euclidean_norm(projected[i] - projected[j]);
+				CHECK(after / before > 1 - epsilon);
+				CHECK(after / before < 1 + epsilon);
+			}
+		}
+	}
+}
+
+TEST_CASE("Target dimensions and errors") {
+	CHECK(comp6771::target_dimensions(0, 0.5) == 1);
+	CHECK(comp6771::target_dimensions(1, 0.5) == 1);
+	CHECK(comp6771::target_dimensions(1'000'000, 0.1) == 11842);
+	CHECK(comp6771::target_dimensions(1'000, 0.5) == 332);
+
+	CHECK_THROWS_MATCHES(comp6771::target_dimensions(10, 0.0),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("epsilon must be between 0 and 1 exclusive"));
+	CHECK_THROWS_AS(comp6771::target_dimensions(10, 1.0), comp6771::euclidean_vector_error);
+	CHECK_THROWS_MATCHES(comp6771::random_projection(10, 0),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot project from 10 to 0 dimensions"));
+	CHECK_THROWS_AS(comp6771::random_projection(0, 5), comp6771::euclidean_vector_error);
+}
@@ -0,0 +1,185 @@
+// tests running mean, variance and covariance: single, batch and merged updates, and errors
+#include "comp6771/running_statistics.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+	constexpr auto dimensions = 5;
+
+	// samples far from the origin with a small spread, which E[x^2] - E[x]^2 gets badly wrong
+	auto make_samples(int const count) -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(6771);
+		auto distribution = std::normal_distribution<double>(0.0, 1.0);
+		auto samples = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto v = comp6771::euclidean_vector(dimensions);
+			for (auto j = 0; j < dimensions; ++j) {
+				v[j] = 1e9 + (j + 1) * distribution(engine);
+			}
+			v[1] += 0.5 * (v[0] - 1e9); // so the covariance isn't diagonal
+			samples.push_back(v);
+		}
+		return samples;
+	}
+
+	// the two-pass textbook versions, to check against
+	auto expected_mean(std::vector<comp6771::euclidean_vector> const& samples) -> std::vector<double> {
+		auto mean = std::vector<double>(dimensions);
+		for (auto const& v : samples) {
+			for (auto j = 0; j < dimensions; ++j) {
+				mean[static_cast<std::size_t>(j)] += v[j];
+			}
+		}
+		for (auto& m : mean) {
+			m /= static_cast<double>(samples.size());
+		}
+		return mean;
+	}
+
+	auto expected_covariance(std::vector<comp6771::euclidean_vector> const& samples, int const i, int const j)
+	   -> double {
+		auto const mean = expected_mean(samples);
+		auto sum = 0.0;
+		for (auto const& v : samples) {
+			sum += (v[i] - mean[static_cast<std::size_t>(i)]) * (v[j] - mean[static_cast<std::size_t>(j)]);
+		}
+		return sum / static_cast<double>(samples.size());
+	}
+
+	auto check_statistics(comp6771::running_statistics const& statistics,
+	                      std::vector<comp6771::euclidean_vector> const& samples) -> void {
+		REQUIRE(statistics.count() == samples.size());
+		auto const mean = expected_mean(samples);
+		auto const covariance = statistics.covariance();
+		auto const variance = statistics.variance();
+		for (auto i = 0; i < dimensions; ++i) {
+			// at 1e9 the plain reference sum is itself only good to around 1e-13
+			CHECK(statistics.mean()[i] == Approx(mean[static_cast<std::size_t>(i)]).epsilon(1e-13));
+			CHECK(variance[i] == Approx(expected_covariance(samples, i, i)).epsilon(1e-6));
+			CHECK(covariance(i, i) == variance[i]);
+			for (auto j = 0; j < dimensions; ++j) {
+				CHECK(covariance(i, j) == Approx(expected_covariance(samples, i, j)).epsilon(1e-6).margin(1e-6));
+				CHECK(covariance(i, j) == covariance(j, i));
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("One sample at a time") {
+	auto const samples = make_samples(1000);
+	auto statistics = comp6771::running_statistics(dimensions, true);
+	CHECK(statistics.count() == 0);
+	CHECK(statistics.tracks_covariance());
+	CHECK(statistics.mean() == comp6771::euclidean_vector(dimensions));
+
+	for (auto const& v : samples) {
+		statistics.add(v);
+	}
+	check_statistics(statistics, samples);
+	CHECK(statistics.variance()[0] == Approx(1).epsilon(0.1));
+	CHECK(statistics.covariance()(0, 1) == Approx(0.5).epsilon(0.2));
+
+	auto const sample_variance = statistics.sample_variance();
+	CHECK(sample_variance[2] == Approx(statistics.variance()[2] * 1000 / 999));
+	CHECK(statistics.sample_covariance()(0, 1) == Approx(statistics.covariance()(0, 1) * 1000 / 999));
+
+	statistics.reset();
+	CHECK(statistics.count() == 0);
+	CHECK(statistics.mean() == comp6771::euclidean_vector(dimensions));
+	statistics.add(samples.front());
+	check_statistics(statistics, {samples.front()});
+}
+
+TEST_CASE("Batches, on any number of threads") {
+	auto const samples = make_samples(1000);
+	auto const matrix = comp6771::euclidean_matrix(samples);
+	for (auto const threads : {1, 3, 8}) {
+		auto from_vectors = comp6771::running_statistics(dimensions, true);
+		from_vectors.add(std::span(samples).first(400), threads);
+		from_vectors.add(std::span(samples).subspan(400), threads);
+		check_statistics(from_vectors, samples);
+
+		auto from_matrix = comp6771::running_statistics(dimensions, true);
+		from_matrix.add(matrix, threads);
+		check_statistics(from_matrix, samples);
+	}
+
+	auto empty = comp6771::running_statistics(dimensions);
+	empty.add(std::vector<comp6771::euclidean_vector>());
+	CHECK(empty.count() == 0);
+}
+
+TEST_CASE("Merging partial statistics") {
+	auto const samples = make_samples(900);
+	auto parts = std::vector<comp6771::running_statistics>();
+	for (auto part = 0; part < 3; ++part) {
+		parts.emplace_back(dimensions, true);
+		for (auto i = part * 300; i < (part + 1) * 300; ++i) {
+			parts.back().add(samples[static_cast<std::size_t>(i)]);
+		}
+	}
+
+	auto total = comp6771::running_statistics(dimensions, true);
+	for (auto const& part : parts) {
+		total.merge(part);
+	}
+	check_statistics(total, samples);
+
+	SECTION("Into an empty one copies exactly") {
+		auto copy = comp6771::running_statistics(dimensions, true);
+		copy.merge(parts[0]);
+		CHECK(copy.mean() == parts[0].mean());
+		CHECK(copy.variance() == parts[0].variance());
+		CHECK(copy.covariance() == parts[0].covariance());
+	}
+	SECTION("Empty ones change nothing") {
+		total.merge(comp6771::running_statistics(dimensions, true));
+		check_statistics(total, samples);
+	}
+	SECTION("Without covariance, from one with it") {
+		auto variance_only = comp6771::running_statistics(dimensions);
+		for (auto const& part : parts) {
+			variance_only.merge(part);
+		}
+		CHECK(variance_only.mean() == total.mean());
+		CHECK(variance_only.variance() == total.variance());
+	}
+}
+
+TEST_CASE("Running statistics errors") {
+	auto statistics = comp6771::running_statistics(3);
+	CHECK_THROWS_MATCHES(statistics.variance(),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("variance needs at least 1 sample"));
+	statistics.add(comp6771::euclidean_vector{1, 2, 3});
+	CHECK(statistics.variance() == comp6771::euclidean_vector(3));
+	CHECK_THROWS_MATCHES(statistics.sample_variance(),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("sample_variance needs at least 2 samples"));
+	CHECK_THROWS_MATCHES(statistics.covariance(),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("running_statistics is not tracking covariance"));
+
+	auto const message = Catch::Matchers::Message("Dimensions of running_statistics and sample (3 and 2) do not match");
+	CHECK_THROWS_MATCHES(statistics.add(comp6771::euclidean_vector{1, 2}), comp6771::euclidean_vector_error, message);
+	CHECK_THROWS_MATCHES(statistics.add(std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {1, 2}}),
+	                     comp6771::euclidean_vector_error,
+	                     message);
+	CHECK_THROWS_MATCHES(statistics.add(comp6771::euclidean_matrix(2, 2)), comp6771::euclidean_vector_error, message);
+	CHECK_THROWS_MATCHES(statistics.merge(comp6771::running_statistics(2)),
+	                     comp6771::euclidean_vector_error,
+	                     message);
+	CHECK(statistics.count() == 1); // nothing added by the failed batches
+
+	auto with_covariance = comp6771::running_statistics(3, true);
+	CHECK_THROWS_MATCHES(with_covariance.merge(statistics),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot merge running_statistics without covariance into one "
+	                                              "with it"));
+}
@@ -0,0 +1,134 @@
+// tests the constexpr, fixed-dimension static_euclidean_vector
+#include "comp6771/static_euclidean_vector.hpp"
+
+#include <array>
+#include <bit>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace {
+	using vec3 = comp6771::static_euclidean_vector<3>;
+
+	// a lookup table built entirely by the compiler
+	constexpr auto axes = std::array<vec3, 3>{comp6771::basis<3>(0),
+	                                         comp6771::basis<3>(1),
+	                                         comp6771::basis<3>(2)};
+	constexpr auto diagonal = comp6771::unit(axes[0] + axes[1] + axes[2]);
+} // namespace
+
+TEST_CASE("Constant evaluation") {
+	STATIC_REQUIRE(vec3().dimensions() == 3);
+	STATIC_REQUIRE(vec3(2.0)[1] == 2.0);
+	STATIC_REQUIRE(vec3{1, 2, 3}.at(2) == 3);
+	STATIC_REQUIRE(axes[1] == vec3{0, 1, 0});
+	STATIC_REQUIRE(-vec3{1, -2, 3} == vec3{-1, 2, -3});
+	STATIC_REQUIRE(vec3{1, 2, 3} + vec3{1, 1, 1} == vec3{2, 3, 4});
+	STATIC_REQUIRE(vec3{1, 2, 3} - vec3{1, 1, 1} == vec3{0, 1, 2});
+	STATIC_REQUIRE(2 * vec3{1, 2, 3} == vec3{2, 4, 6});
+	STATIC_REQUIRE(vec3{1, 2, 3} / 2 == vec3{0.5, 1, 1.5});
+	STATIC_REQUIRE(comp6771::dot(vec3{1, 2, 3}, vec3{4, 5, 6}) == 32);
+	STATIC_REQUIRE(comp6771::euclidean_norm(comp6771::static_euclidean_vector<2>{3, 4}) == 5);
+	STATIC_REQUIRE(comp6771::unit(comp6771::static_euclidean_vector<2>{3, 4})
+	               == comp6771::static_euclidean_vector<2>{0.6, 0.8});
+	STATIC_REQUIRE(diagonal[0] == diagonal[2]);
+}
+
+TEST_CASE("Same results as euclidean_vector at run time") {
+	auto const v = vec3{1.5, -2.25, 7.0};
+	auto const dynamic = comp6771::euclidean_vector(v);
+	CHECK(dynamic == comp6771::euclidean_vector{1.5, -2.25, 7.0});
+
+	constexpr auto constant_norm = comp6771::euclidean_norm(vec3{1.5, -2.25, 7.0});
+	CHECK(constant_norm == comp6771::euclidean_norm(dynamic));
+	CHECK(comp6771::euclidean_norm(v) == comp6771::euclidean_norm(dynamic));
+	CHECK(comp6771::euclidean_vector(diagonal) == comp6771::unit(comp6771::euclidean_vector{1, 1, 1}));
+
+	auto os = std::ostringstream();
+	os << v;
+	CHECK(os.str() == "[1.5 -2.25 7]");
+}
+
+TEST_CASE("Same dot and norm as euclidean_vector in more dimensions") {
+	// with 8 dimensions any difference in summation order would show up
+	auto engine = std::mt19937_64(6771);
+	auto distribution = std::uniform_real_distribution<double>(-1.0, 1.0);
+	for (auto trial = 0; trial < 1000; ++trial) {
+		auto a = comp6771::static_euclidean_vector<8>();
+		auto b = comp6771::static_euclidean_vector<8>();
+		for (auto i = 0; i < 8; ++i) {
+			a[i] = distribution(engine);
+			b[i] = distribution(engine);
+		}
+		auto const dynamic_a = comp6771::euclidean_vector(a);
+		auto const dynamic_b = comp6771::euclidean_vector(b);
+		REQUIRE(comp6771::dot(a, b) == comp6771::dot(dynamic_a, dynamic_b));
+		REQUIRE(comp6771::euclidean_norm(a) == comp6771::euclidean_norm(dynamic_a));
+		// unit() divides by the fast norm
+		REQUIRE(comp6771::euclidean_vector(comp6771::unit(a))
+		        == dynamic_a / comp6771::euclidean_norm(dynamic_a));
+	}
+}
+
+TEST_CASE("Run-time errors") {
+	CHECK_THROWS_MATCHES(vec3({1, 2}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Expected 3 magnitudes but got 2"));
+	CHECK_THROWS_MATCHES(vec3().at(3),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Index 3 is not valid for this euclidean_vector "
+	                                              "object"));
+	CHECK_THROWS_MATCHES(vec3(1) / 0,
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Invalid vector division by 0"));
+	CHECK_THROWS_MATCHES(comp6771::unit(vec3()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal does "
+	                                              "not have a unit vector"));
+}
+
+TEST_CASE("constexpr square root is correctly rounded") {
+	auto const bits = [](double const x) { return std::bit_cast<std::uint64_t>(x); };
+	auto const agrees = [&](double const x) {
+		return bits(comp6771::detail::constexpr_sqrt(x)) == bits(std::sqrt(x));
+	};
+
+	SECTION("Special values") {
+		constexpr auto inf = std::numeric_limits<double>::infinity();
+		CHECK(agrees(0.0));
+		CHECK(agrees(-0.0));
+		CHECK(agrees(inf));
+		CHECK(std::isnan(comp6771::detail::constexpr_sqrt(-1.0)));
+		CHECK(std::isnan(comp6771::detail::constexpr_sqrt(std::numeric_limits<double>::quiet_NaN())));
+		CHECK(agrees(std::numeric_limits<double>::denorm_min()));
+		CHECK(agrees(std::numeric_limits<double>::min()));
+		CHECK(agrees(std::numeric_limits<double>::max()));
+		STATIC_REQUIRE(comp6771::detail::constexpr_sqrt(2.0) == 1.4142135623730951);
+	}
+
+	SECTION("Random doubles across the whole range") {
+		auto engine = std::mt19937_64(11);
+		auto mismatches = 0;
+		for (auto i = 0; i < 200000; ++i) {
+			// uniformly random bit patterns of positive doubles, so every exponent is covered
+			auto const x = std::bit_cast<double>(engine() >> 1);
+			if (std::isfinite(x) and not agrees(x)) {
+				++mismatches;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	SECTION("Perfect squares and their neighbours") {
+		for (auto n = 1.0; n < 5000.0; n += 1.0) {
+			CHECK(comp6771::detail::constexpr_sqrt(n * n) == n);
+			CHECK(agrees(std::nextafter(n * n, 0.0)));
+			CHECK(agrees(std::nextafter(n * n, 1e300)));
+		}
+	}
+}
@@ -0,0 +1,115 @@
+// tests top-k selection: against a full sort, ties, NaN, threading and errors
+#include "comp6771/top_k.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+	auto make_vectors(int const count, int const dimensions) -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(6771);
+		auto distribution = std::normal_distribution<double>(0.0, 1.0);
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto v = comp6771::euclidean_vector(dimensions);
+			for (auto j = 0; j < dimensions; ++j) {
+				v[j] = distribution(engine);
+			}
+			vectors.push_back(v);
+		}
+		return vectors;
+	}
+
+	// the straightforward way: score everything, sort everything, keep the first k
+	auto full_sort(std::vector<double> const& scores, std::size_t const k) -> std::vector<std::size_t> {
+		auto indices = std::vector<std::size_t>(scores.size());
+		for (auto i = std::size_t{0}; i < indices.size(); ++i) {
+			indices[i] = i;
+		}
+		std::stable_sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) {
+			return scores[a] > scores[b];
+		});
+		indices.resize(std::min(k, indices.size()));
+		return indices;
+	}
+
+	auto indices_of(std::vector<comp6771::scored_index> const& result) -> std::vector<std::size_t> {
+		auto indices = std::vector<std::size_t>();
+		for (auto const& [index, score] : result) {
+			indices.push_back(index);
+		}
+		return indices;
+	}
+} // namespace
+
+TEST_CASE("Top-k agrees with a full sort") {
+	auto const vectors = make_vectors(1000, 16);
+	auto const query = vectors[7];
+	auto norms = std::vector<double>();
+	auto dots = std::vector<double>();
+	for (auto const& v : vectors) {
+		norms.push_back(std::sqrt(comp6771::dot(v, v, comp6771::unchecked)));
+		dots.push_back(comp6771::dot(v, query, comp6771::unchecked));
+	}
+	auto const matrix = comp6771::euclidean_matrix(vectors);
+
+	for (auto const threads : {1, 3, 8}) {
+		for (auto const k : {std::size_t{1}, std::size_t{10}, std::size_t{999}}) {
+			auto const by_norm = comp6771::top_k_by_norm(vectors, k, threads);
+			CHECK(indices_of(by_norm) == full_sort(norms, k));
+			CHECK(by_norm.front().score == *std::max_element(norms.begin(), norms.end()));
+			CHECK(indices_of(comp6771::top_k_by_norm(matrix, k, threads)) == full_sort(norms, k));
+
+			auto const by_dot = comp6771::top_k_by_dot(query, vectors, k, threads);
+			CHECK(indices_of(by_dot) == full_sort(dots, k));
+			CHECK(by_dot.front().index == 7);
+			CHECK(indices_of(comp6771::top_k_by_dot(query, matrix, k, threads)) == full_sort(dots, k));
+
+			CHECK(indices_of(comp6771::top_k(dots, k, threads)) == full_sort(dots, k));
+		}
+	}
+}
+
+TEST_CASE("Ties come in index order whatever the thread count") {
+	auto const scores = std::vector<double>{1, 3, 2, 3, 3, 1, 2, 3};
+	for (auto const threads : {1, 2, 4, 8}) {
+		CHECK(indices_of(comp6771::top_k(scores, 3, threads)) == std::vector<std::size_t>{1, 3, 4});
+		CHECK(indices_of(comp6771::top_k(scores, 6, threads)) == std::vector<std::size_t>{1, 3, 4, 7, 2, 6});
+	}
+}
+
+TEST_CASE("NaN scores are never selected") {
+	auto const nan = std::numeric_limits<double>::quiet_NaN();
+	auto const scores = std::vector<double>{nan, 2, nan, -1, nan};
+	for (auto const threads : {1, 2, 5}) {
+		auto const result = comp6771::top_k(scores, 4, threads);
+		CHECK(indices_of(result) == std::vector<std::size_t>{1, 3});
+		CHECK(result[0].score == 2);
+	}
+}
+
+TEST_CASE("k out of range") {
+	auto const vectors = make_vectors(5, 3);
+	CHECK(comp6771::top_k_by_norm(vectors, 0).empty());
+	CHECK(comp6771::top_k_by_norm(vectors, 10, 4).size() == 5);
+	CHECK(comp6771::top_k_by_norm(std::vector<comp6771::euclidean_vector>(), 3).empty());
+	CHECK(comp6771::top_k(std::vector<double>(), 3, 2).empty());
+}
+
+TEST_CASE("Mismatched dimensions throw") {
+	auto const query = comp6771::euclidean_vector{1, 2, 3};
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {1, 2}};
+	CHECK_THROWS_MATCHES(comp6771::top_k_by_dot(query, vectors, 1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+	CHECK_THROWS_MATCHES(comp6771::top_k_by_dot(query, comp6771::euclidean_matrix(4, 2), 1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of matrix columns and euclidean_vector (2 and 3) "
+	                                              "do not match"));
+}